@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "bench_env.hpp"
+
+namespace binghamton {
+namespace bench {
+    namespace {
+
+        struct bench_entry {
+            std::string name;
+            std::function<void()> function;
+        };
+
+        std::vector<bench_entry>& _registry()
+        {
+            static std::vector<bench_entry> _entries;
+            return _entries;
+        }
+
+        std::string _current_bench;
+        bool _json = false;
+        bool _first_report = true;
+        double _max_megapixels = 100.0;
+
+    }
+
+    bool register_bench(
+        const std::string& name,
+        const std::function<void()>& function)
+    {
+        _registry().push_back({ name, function });
+        return true;
+    }
+
+    void report(
+        const std::string& label,
+        const std::string& metric,
+        const double value,
+        const std::string& unit)
+    {
+        if (_json) {
+            std::printf("%s\n  {\"bench\": \"%s\", \"label\": \"%s\", \"metric\": \"%s\", \"value\": %.6g, \"unit\": \"%s\"}",
+                _first_report ? "" : ",", _current_bench.c_str(), label.c_str(), metric.c_str(), value, unit.c_str());
+        } else {
+            std::printf("%s,%s,%s,%.6g,%s\n", _current_bench.c_str(), label.c_str(), metric.c_str(), value, unit.c_str());
+        }
+        _first_report = false;
+        std::fflush(stdout);
+    }
+
+    double max_megapixels()
+    {
+        return _max_megapixels;
+    }
+
+    double measure_seconds(
+        const std::function<void()>& function,
+        const std::size_t repetitions)
+    {
+        double _best = std::numeric_limits<double>::infinity();
+        for (std::size_t _repetition = 0; _repetition < repetitions; ++_repetition) {
+            const auto _start = std::chrono::steady_clock::now();
+            function();
+            const auto _stop = std::chrono::steady_clock::now();
+            _best = std::min(_best, std::chrono::duration<double>(_stop - _start).count());
+        }
+        return _best;
+    }
+
+    void make_random_bits(
+        const std::size_t count,
+        const std::uint32_t seed,
+        std::vector<std::uint8_t>& bits)
+    {
+        std::mt19937 _generator(seed);
+        bits.resize(count);
+        for (std::size_t _index = 0; _index < count; ++_index) {
+            bits[_index] = static_cast<std::uint8_t>(_generator() & 1u);
+        }
+    }
+
+    void make_random_prices(
+        const std::size_t count,
+        const std::uint32_t seed,
+        std::vector<std::uint8_t>& prices)
+    {
+        // Exponentially distributed prices mimic the heavy tail of content-adaptive cost maps
+        std::mt19937 _generator(seed);
+        std::exponential_distribution<float> _distribution(1.0f / 24.0f);
+        prices.resize(count);
+        for (std::size_t _index = 0; _index < count; ++_index) {
+            prices[_index] = static_cast<std::uint8_t>(std::min(255.0f, 1.0f + _distribution(_generator)));
+        }
+    }
+
+    void make_synthetic_y(
+        const std::size_t width,
+        const std::size_t height,
+        const std::uint32_t seed,
+        std::vector<std::uint8_t>& y)
+    {
+        // Flat sky on top, a textured and noisy ground below, with a hard horizon between them
+        std::mt19937 _generator(seed);
+        std::normal_distribution<float> _noise(0.0f, 6.0f);
+        y.resize(width * height);
+        for (std::size_t _row = 0; _row < height; ++_row) {
+            for (std::size_t _column = 0; _column < width; ++_column) {
+                float _value = 0.0f;
+                if (3 * _row < height) {
+                    _value = 180.0f + 40.0f * static_cast<float>(_row) / static_cast<float>(height);
+                } else {
+                    const float _texture = 30.0f * std::sin(0.11f * static_cast<float>(_column)) * std::cos(0.07f * static_cast<float>(_row));
+                    _value = 90.0f + _texture + _noise(_generator);
+                }
+                y[_row * width + _column] = static_cast<std::uint8_t>(std::min(255.0f, std::max(0.0f, std::round(_value))));
+            }
+        }
+    }
+
+}
+}
+
+int main(int argc, char** argv)
+{
+    // Options start with --, the other arguments select benchmarks by name
+    std::vector<const char*> _names;
+    for (int _arg = 1; _arg < argc; ++_arg) {
+        if (std::strcmp(argv[_arg], "--format=json") == 0) {
+            binghamton::bench::_json = true;
+        } else if (std::strcmp(argv[_arg], "--format=csv") == 0) {
+            binghamton::bench::_json = false;
+        } else if (std::strncmp(argv[_arg], "--max-megapixels=", 17) == 0) {
+            binghamton::bench::_max_megapixels = std::atof(argv[_arg] + 17);
+        } else if (std::strncmp(argv[_arg], "--", 2) == 0) {
+            std::fprintf(stderr, "unknown option %s, expected --format=csv, --format=json or --max-megapixels=<value>\n", argv[_arg]);
+            return 1;
+        } else {
+            _names.push_back(argv[_arg]);
+        }
+    }
+
+    std::printf(binghamton::bench::_json ? "[" : "bench,label,metric,value,unit\n");
+    for (const auto& _entry : binghamton::bench::_registry()) {
+        bool _selected = _names.empty();
+        for (const char* _name : _names) {
+            _selected = _selected || (_entry.name == _name);
+        }
+        if (_selected) {
+            binghamton::bench::_current_bench = _entry.name;
+            _entry.function();
+        }
+    }
+    if (binghamton::bench::_json) {
+        std::printf("\n]\n");
+    }
+    return 0;
+}
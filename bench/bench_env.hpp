@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace binghamton {
+namespace bench {
+
+    /// @brief Registers a benchmark so that the bench executable runs it
+    /// @param name the name reported in front of every measurement
+    /// @param function the benchmark body
+    bool register_bench(
+        const std::string& name,
+        const std::function<void()>& function);
+
+    /// @brief Reports one measurement as a CSV line bench,label,metric,value,unit, or as a JSON object of these
+    /// fields when the executable runs with --format=json
+    /// @param label the case measured by the benchmark (size, parameter...)
+    /// @param metric the name of the measured quantity
+    /// @param value the measured value
+    /// @param unit the unit of the measured value
+    void report(
+        const std::string& label,
+        const std::string& metric,
+        const double value,
+        const std::string& unit);
+
+    /// @brief Gets the size of the largest synthetic image a benchmark may create, 100 unless the executable runs
+    /// with --max-megapixels=<value>
+    double max_megapixels();
+
+    /// @brief Returns the best wall time in seconds of a function over a few repetitions
+    /// @param function the function to time
+    /// @param repetitions the count of timed runs
+    double measure_seconds(
+        const std::function<void()>& function,
+        const std::size_t repetitions = 3);
+
+    /// @brief Generates deterministic random bits
+    /// @param count the count of bits to generate
+    /// @param seed the seed of the generator
+    /// @param bits the generated bits, one per byte
+    void make_random_bits(
+        const std::size_t count,
+        const std::uint32_t seed,
+        std::vector<std::uint8_t>& bits);
+
+    /// @brief Generates deterministic random prices
+    /// @param count the count of prices to generate
+    /// @param seed the seed of the generator
+    /// @param prices the generated prices
+    void make_random_prices(
+        const std::size_t count,
+        const std::uint32_t seed,
+        std::vector<std::uint8_t>& prices);
+
+    /// @brief Generates a deterministic synthetic Y plane mixing smooth gradients, edges and noise
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param seed the seed of the generator
+    /// @param y the generated Y pixels
+    void make_synthetic_y(
+        const std::size_t width,
+        const std::size_t height,
+        const std::uint32_t seed,
+        std::vector<std::uint8_t>& y);
+
+}
+}
+
+#define BINGHAMTON_BENCH_CONCAT_IMPL(a, b) a##b
+#define BINGHAMTON_BENCH_CONCAT(a, b) BINGHAMTON_BENCH_CONCAT_IMPL(a, b)
+
+/// @brief Defines and registers a benchmark body
+#define BINGHAMTON_BENCH(name)                                                                                  \
+    static void BINGHAMTON_BENCH_CONCAT(bench_, name)();                                                        \
+    static const bool BINGHAMTON_BENCH_CONCAT(bench_registered_, name)                                          \
+        = ::binghamton::bench::register_bench(#name, &BINGHAMTON_BENCH_CONCAT(bench_, name));                   \
+    static void BINGHAMTON_BENCH_CONCAT(bench_, name)()
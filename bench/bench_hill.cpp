@@ -0,0 +1,50 @@
+#include <string>
+
+#include <binghamton/method/hill.hpp>
+#include <binghamton/method/wow.hpp>
+
+#include "bench_env.hpp"
+
+namespace binghamton {
+namespace bench {
+
+    BINGHAMTON_BENCH(hill_against_wow)
+    {
+        // Throughput of the HILL and WOW cost maps, then of a whole embedding at 1/8 bit per pixel
+        std::array<std::uint8_t, 32> _key {};
+        for (const std::size_t _side : { 512, 1024, 2048 }) {
+            const std::size_t _pixels_count = _side * _side;
+            std::vector<std::uint8_t> _y, _price, _rgb(3 * _pixels_count), _rgb_embedded;
+            make_synthetic_y(_side, _side, 1, _y);
+            for (std::size_t _index = 0; _index < _pixels_count; ++_index) {
+                _rgb[3 * _index] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = _y[_index];
+            }
+            std::vector<std::uint8_t> _payload_bytes;
+            make_random_bits(_pixels_count / 8, 2, _payload_bytes);
+            bit_vector _payload;
+            pack_bits(_payload_bytes, _payload);
+
+            const double _hill_price_seconds = measure_seconds([&]() {
+                price_hill(_y, _side, _side, _price);
+            });
+            const double _wow_price_seconds = measure_seconds([&]() {
+                price_wow(_y, _side, _side, _price);
+            });
+            double _cost;
+            const double _hill_embed_seconds = measure_seconds([&]() {
+                embed_hill(_rgb, _side, _side, _key, 7, _payload, _rgb_embedded, _cost);
+            }, 1);
+            const double _wow_embed_seconds = measure_seconds([&]() {
+                embed_wow(_rgb, _side, _side, _key, 7, _payload, _rgb_embedded, _cost);
+            }, 1);
+
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            report(_label, "hill_price_throughput", 1e-6 * static_cast<double>(_pixels_count) / _hill_price_seconds, "MP/s");
+            report(_label, "wow_price_throughput", 1e-6 * static_cast<double>(_pixels_count) / _wow_price_seconds, "MP/s");
+            report(_label, "hill_embed_throughput", 1e-6 * static_cast<double>(_pixels_count) / _hill_embed_seconds, "MP/s");
+            report(_label, "wow_embed_throughput", 1e-6 * static_cast<double>(_pixels_count) / _wow_embed_seconds, "MP/s");
+        }
+    }
+
+}
+}
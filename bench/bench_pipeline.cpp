@@ -0,0 +1,109 @@
+#include <cmath>
+#include <string>
+
+#include <binghamton/core/lsb.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/core/stc.hpp>
+#include <binghamton/core/ycbcr.hpp>
+#include <binghamton/method/wow.hpp>
+
+#include "bench_env.hpp"
+
+namespace binghamton {
+namespace bench {
+    namespace {
+
+        void _report_stage(
+            const std::string& label,
+            const std::string& stage,
+            const double seconds,
+            const std::size_t pixels_count)
+        {
+            report(label, stage + "_throughput", 1e-6 * static_cast<double>(pixels_count) / seconds, "MP/s");
+            report(label, stage + "_time", 1e9 * seconds / static_cast<double>(pixels_count), "ns/pixel");
+        }
+
+    }
+
+    BINGHAMTON_BENCH(stages)
+    {
+        // Every stage of the pipeline on square synthetic images from 0.1 MP, at 0.03 bits per pixel and
+        // a constraint height of 7, up to --max-megapixels
+        for (const double _megapixels : { 0.1, 1.0, 10.0, 100.0 }) {
+            if (_megapixels > max_megapixels()) {
+                break;
+            }
+            const std::size_t _side = static_cast<std::size_t>(std::round(std::sqrt(1e6 * _megapixels)));
+            const std::size_t _pixels_count = _side * _side;
+            const std::size_t _repetitions = _pixels_count < 5000000 ? 3 : 1;
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            const std::array<std::uint8_t, 32> _key {};
+
+            std::vector<std::uint8_t> _y, _rgb, _bits;
+            make_synthetic_y(_side, _side, 1, _y);
+            _rgb.resize(3 * _pixels_count);
+            for (std::size_t _index = 0; _index < _pixels_count; ++_index) {
+                _rgb[3 * _index + 0] = static_cast<std::uint8_t>(_y[_index] / 2 + 60);
+                _rgb[3 * _index + 1] = _y[_index];
+                _rgb[3 * _index + 2] = static_cast<std::uint8_t>(255 - _y[_index] / 2);
+            }
+            make_random_bits(_pixels_count / 32, 1, _bits);
+            bit_vector _payload;
+            pack_bits(_bits, _payload);
+
+            {
+                std::vector<std::uint8_t> _y_encoded, _price, _y_embedded, _rgb_embedded;
+                bit_vector _symbols, _stego_symbols, _payload_decoded;
+                _report_stage(_label, "encode_y", measure_seconds([&]() {
+                    encode_y(_rgb, _y_encoded);
+                }, _repetitions), _pixels_count);
+                _report_stage(_label, "encode_lsb", measure_seconds([&]() {
+                    encode_lsb(_y_encoded, _symbols);
+                }, _repetitions), _pixels_count);
+                _report_stage(_label, "price_wow", measure_seconds([&]() {
+                    price_wow(_y_encoded, _side, _side, _price);
+                }, _repetitions), _pixels_count);
+                // The STC runs on the symbols and prices in the order of the permutation, as in the pipeline,
+                // so that the wet flat areas of the image are spread over the trellis
+                std::vector<std::size_t> _permutation;
+                _report_stage(_label, "make_permutation", measure_seconds([&]() {
+                    make_permutation(_key, 0, _pixels_count, _permutation);
+                }, _repetitions), _pixels_count);
+                bit_vector _symbols_stc;
+                std::vector<std::uint8_t> _price_stc(_pixels_count);
+                _symbols_stc.resize(_pixels_count);
+                for (std::size_t _index = 0; _index < _pixels_count; ++_index) {
+                    _symbols_stc.set(_index, _symbols.get(_permutation[_index]));
+                    _price_stc[_index] = _price[_permutation[_index]];
+                }
+                std::vector<std::size_t>().swap(_permutation);
+                stc_options _options;
+                _options.wet_symbols = true;
+                _report_stage(_label, "encode_stc", measure_seconds([&]() {
+                    encode_stc(_symbols_stc, _payload, _price_stc, 7, _options, _stego_symbols);
+                }, _repetitions), _pixels_count);
+                _report_stage(_label, "decode_stc", measure_seconds([&]() {
+                    decode_stc(_stego_symbols, 7, _payload.size, _payload_decoded);
+                }, _repetitions), _pixels_count);
+                decode_lsb(_y_encoded, _stego_symbols, _y_embedded);
+                _report_stage(_label, "decode_y", measure_seconds([&]() {
+                    decode_y(_rgb, _y_embedded, _rgb_embedded);
+                }, _repetitions), _pixels_count);
+            }
+
+            // The whole pipeline with a warm workspace, once the buffers of the stages are freed
+            std::vector<std::uint8_t> _rgb_embedded;
+            bit_vector _payload_extracted;
+            workspace _workspace;
+            double _cost;
+            _report_stage(_label, "embed_wow", measure_seconds([&]() {
+                embed_wow(_rgb, _side, _side, _key, 7, _payload, embed_options {}, _workspace, _rgb_embedded, _cost);
+            }, _repetitions), _pixels_count);
+            _report_stage(_label, "extract_wow", measure_seconds([&]() {
+                extract_wow(_rgb_embedded, _side, _side, _key, 7, _payload.size, extract_options {}, _workspace, _payload_extracted);
+            }, _repetitions), _pixels_count);
+        }
+    }
+
+}
+}
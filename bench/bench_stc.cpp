@@ -0,0 +1,241 @@
+#include <string>
+
+#include <binghamton/core/lsb.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/core/stc.hpp>
+#include <binghamton/core/ycbcr.hpp>
+
+#include "bench_env.hpp"
+
+namespace binghamton {
+namespace bench {
+
+    BINGHAMTON_BENCH(stc_distortion)
+    {
+        // Distortion per embedded bit at several relative payloads, height 0 is the block parity code
+        constexpr std::size_t _cover_count = 1 << 18;
+        std::vector<std::uint8_t> _cover, _prices, _stego, _message;
+        make_random_bits(_cover_count, 1, _cover);
+        make_random_prices(_cover_count, 2, _prices);
+
+        for (const std::size_t _rate_inverse : { 2, 4, 8, 16 }) {
+            make_random_bits(_cover_count / _rate_inverse, 3, _message);
+            for (const std::uint32_t _height : { 0u, 4u, 7u, 10u }) {
+                const double _distortion = encode_stc(_cover, _message, _prices, _height, _stego);
+                const std::string _label = "alpha=1/" + std::to_string(_rate_inverse) + " h=" + std::to_string(_height);
+                report(_label, "distortion_per_bit", _distortion / static_cast<double>(_message.size()), "price");
+            }
+        }
+    }
+
+    BINGHAMTON_BENCH(stc_throughput)
+    {
+        // Throughput per constraint height, the cover shrinks with the state count to bound run time
+        for (std::uint32_t _height = 0; _height <= 15; ++_height) {
+            const std::size_t _cover_count = std::size_t(1) << (_height <= 8 ? 20 : 28 - _height);
+            std::vector<std::uint8_t> _cover, _prices, _stego, _message, _decoded;
+            make_random_bits(_cover_count, 1, _cover);
+            make_random_prices(_cover_count, 2, _prices);
+            make_random_bits(_cover_count / 4, 3, _message);
+
+            const std::string _label = "alpha=1/4 h=" + std::to_string(_height);
+            const double _encode_seconds = measure_seconds([&]() {
+                encode_stc(_cover, _message, _prices, _height, _stego);
+            });
+            const double _decode_seconds = measure_seconds([&]() {
+                decode_stc(_stego, _height, _message.size(), _decoded);
+            });
+            report(_label, "encode_throughput", 1e-6 * static_cast<double>(_cover_count) / _encode_seconds, "MP/s");
+            report(_label, "decode_throughput", 1e-6 * static_cast<double>(_cover_count) / _decode_seconds, "MP/s");
+        }
+    }
+
+    BINGHAMTON_BENCH(stc_packed_decode)
+    {
+        // Extraction throughput of the bit-packed decoder against the one byte per symbol decoder
+        constexpr std::size_t _cover_count = 1 << 22;
+        std::vector<std::uint8_t> _stego, _decoded;
+        bit_vector _stego_packed, _decoded_packed;
+        make_random_bits(_cover_count, 1, _stego);
+        pack_bits(_stego, _stego_packed);
+
+        for (const std::size_t _rate_inverse : { 2, 8 }) {
+            for (const std::uint32_t _height : { 0u, 7u, 10u }) {
+                const std::size_t _message_count = _cover_count / _rate_inverse;
+                const double _bytes_seconds = measure_seconds([&]() {
+                    decode_stc(_stego, _height, _message_count, _decoded);
+                });
+                const double _packed_seconds = measure_seconds([&]() {
+                    decode_stc(_stego_packed, _height, _message_count, _decoded_packed);
+                });
+                const std::string _label = "alpha=1/" + std::to_string(_rate_inverse) + " h=" + std::to_string(_height);
+                report(_label, "bytes_decode_throughput", 1e-6 * static_cast<double>(_cover_count) / _bytes_seconds, "MP/s");
+                report(_label, "packed_decode_throughput", 1e-6 * static_cast<double>(_cover_count) / _packed_seconds, "MP/s");
+            }
+        }
+    }
+
+    BINGHAMTON_BENCH(stc_bounded_memory)
+    {
+        // Recompute overhead of checkpointed back-tracking under shrinking path memory limits
+        constexpr std::size_t _cover_count = 1 << 20;
+        constexpr std::uint32_t _height = 8;
+        std::vector<std::uint8_t> _cover, _prices, _stego, _message;
+        make_random_bits(_cover_count, 1, _cover);
+        make_random_prices(_cover_count, 2, _prices);
+        make_random_bits(_cover_count / 4, 3, _message);
+
+        const std::size_t _full_path_memory = _cover_count * ((std::size_t(1) << _height) / 8);
+        for (const std::size_t _divisor : { 1, 4, 16, 64 }) {
+            stc_options _options;
+            _options.path_memory_limit = _divisor == 1 ? 0 : _full_path_memory / _divisor;
+            const std::string _label = "h=8 limit=1/" + std::to_string(_divisor);
+            const double _seconds = measure_seconds([&]() {
+                encode_stc(_cover, _message, _prices, _height, _options, _stego);
+            });
+            report(_label, "path_memory_limit", static_cast<double>(_full_path_memory / _divisor) / (1 << 20), "MiB");
+            report(_label, "encode_throughput", 1e-6 * static_cast<double>(_cover_count) / _seconds, "MP/s");
+        }
+    }
+
+    BINGHAMTON_BENCH(stc_segmented)
+    {
+        // Speedup of parallel segments and their distortion cost against a single code
+        constexpr std::size_t _cover_count = 1 << 20;
+        constexpr std::uint32_t _height = 7;
+        std::vector<std::uint8_t> _cover, _prices, _stego, _message;
+        make_random_bits(_cover_count, 1, _cover);
+        make_random_prices(_cover_count, 2, _prices);
+        make_random_bits(_cover_count / 4, 3, _message);
+
+        thread_pool _pool;
+        stc_options _options;
+        double _single_seconds = 0.0;
+        double _single_distortion = 0.0;
+        for (const std::size_t _segment_count : { 1, 2, 4, 8, 16, 64 }) {
+            _options.segment_count = _segment_count;
+            _options.pool = &_pool;
+            double _distortion = 0.0;
+            const double _seconds = measure_seconds([&]() {
+                _distortion = encode_stc(_cover, _message, _prices, _height, _options, _stego);
+            });
+            if (_segment_count == 1) {
+                _single_seconds = _seconds;
+                _single_distortion = _distortion;
+            }
+            const std::string _label = "h=7 threads=" + std::to_string(_pool.size()) + " segments=" + std::to_string(_segment_count);
+            report(_label, "encode_throughput", 1e-6 * static_cast<double>(_cover_count) / _seconds, "MP/s");
+            report(_label, "speedup", _single_seconds / _seconds, "x");
+            report(_label, "distortion_increase", 100.0 * (_distortion / _single_distortion - 1.0), "%");
+        }
+    }
+
+    BINGHAMTON_BENCH(permutation)
+    {
+        // Building the shuffled table against mapping every position with the feistel network
+        const std::array<std::uint8_t, 32> _key {};
+        for (const std::size_t _side : { 512, 2048, 4096 }) {
+            const std::size_t _count = _side * _side;
+            std::vector<std::size_t> _indices;
+            const double _shuffle_seconds = measure_seconds([&]() {
+                make_permutation(_key, 0, _count, _indices);
+            });
+            volatile std::size_t _checksum = 0;
+            const double _feistel_seconds = measure_seconds([&]() {
+                const feistel_permutation _feistel(_key, 0, _count);
+                std::size_t _sum = 0;
+                for (std::size_t _index = 0; _index < _count; ++_index) {
+                    _sum += _feistel(_index);
+                }
+                _checksum = _sum;
+            });
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            report(_label, "shuffle_throughput", 1e-6 * static_cast<double>(_count) / _shuffle_seconds, "MP/s");
+            report(_label, "feistel_throughput", 1e-6 * static_cast<double>(_count) / _feistel_seconds, "MP/s");
+            report(_label, "shuffle_memory", static_cast<double>(_count * sizeof(std::size_t)) / (1 << 20), "MiB");
+        }
+    }
+
+
+    BINGHAMTON_BENCH(permutation_gather)
+    {
+        // Gathering the prices in payload order and scattering the stego bytes back, as the embedding
+        // does, through the shuffled table, the feistel network and the blocked table
+        const std::array<std::uint8_t, 32> _key {};
+        for (const std::size_t _side : { 1024, 4096 }) {
+            const std::size_t _count = _side * _side;
+            std::vector<std::uint8_t> _prices, _gathered(_count), _scattered(_count);
+            make_random_prices(_count, 1, _prices);
+            std::vector<std::size_t> _indices, _blocked_indices(_count);
+            make_permutation(_key, 0, _count, _indices);
+            const double _blocked_seconds = measure_seconds([&]() {
+                make_blocked_permutation(_key, 0, _count, _blocked_indices.data());
+            });
+            const feistel_permutation _feistel(_key, 0, _count);
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+
+            const auto _run = [&](const std::string& name, const auto& permutation) {
+                const double _gather_seconds = measure_seconds([&]() {
+                    for (std::size_t _index = 0; _index < _count; ++_index) {
+                        _gathered[_index] = _prices[permutation(_index)];
+                    }
+                });
+                const double _scatter_seconds = measure_seconds([&]() {
+                    for (std::size_t _index = 0; _index < _count; ++_index) {
+                        _scattered[permutation(_index)] = _gathered[_index];
+                    }
+                });
+                report(_label, name + "_gather_throughput", 1e-6 * static_cast<double>(_count) / _gather_seconds, "MP/s");
+                report(_label, name + "_scatter_throughput", 1e-6 * static_cast<double>(_count) / _scatter_seconds, "MP/s");
+            };
+            _run("shuffle", [&](const std::size_t index) { return _indices[index]; });
+            _run("feistel", _feistel);
+            _run("blocked", [&](const std::size_t index) { return _blocked_indices[index]; });
+            report(_label, "blocked_table_throughput", 1e-6 * static_cast<double>(_count) / _blocked_seconds, "MP/s");
+        }
+    }
+
+    BINGHAMTON_BENCH(y_lsb)
+    {
+        // Separate Y and LSB passes against the fused kernels, reinjecting one change per 16 pixels
+        for (const std::size_t _side : { 1024, 4096 }) {
+            const std::size_t _count = _side * _side;
+            std::vector<std::uint8_t> _y, _rgb(3 * _count), _y_embedded, _rgb_embedded(3 * _count), _flip_bits;
+            make_synthetic_y(_side, _side, 1, _y);
+            for (std::size_t _index = 0; _index < _count; ++_index) {
+                _rgb[3 * _index + 0] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = static_cast<std::uint8_t>(std::min(254, std::max(1, int(_y[_index]))));
+            }
+            make_random_bits(_count, 2, _flip_bits);
+            bit_vector _y_lsb, _y_lsb_embedded, _flips;
+            _flips.resize(_count);
+            encode_y(_rgb, _y);
+            encode_lsb(_y, _y_lsb);
+            _y_lsb_embedded = _y_lsb;
+            for (std::size_t _index = 0; _index < _count; _index += 16) {
+                _flips.set(_index, _flip_bits[_index] != 0);
+                _y_lsb_embedded.set(_index, _y_lsb.get(_index) != (_flip_bits[_index] != 0));
+            }
+
+            const double _separate_embed_seconds = measure_seconds([&]() {
+                decode_lsb(_y, _y_lsb_embedded, _y_embedded);
+                decode_y(_rgb, _y_embedded, _rgb_embedded);
+            });
+            const double _fused_embed_seconds = measure_seconds([&]() {
+                decode_y_lsb(_rgb.data(), _flips, _rgb_embedded.data());
+            });
+            const double _separate_extract_seconds = measure_seconds([&]() {
+                encode_y(_rgb_embedded, _y_embedded);
+                encode_lsb(_y_embedded, _y_lsb);
+            });
+            const double _fused_extract_seconds = measure_seconds([&]() {
+                encode_y_lsb(_rgb_embedded.data(), _count, _y_lsb);
+            });
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            report(_label, "separate_embed_throughput", 1e-6 * static_cast<double>(_count) / _separate_embed_seconds, "MP/s");
+            report(_label, "fused_embed_throughput", 1e-6 * static_cast<double>(_count) / _fused_embed_seconds, "MP/s");
+            report(_label, "separate_extract_throughput", 1e-6 * static_cast<double>(_count) / _separate_extract_seconds, "MP/s");
+            report(_label, "fused_extract_throughput", 1e-6 * static_cast<double>(_count) / _fused_extract_seconds, "MP/s");
+        }
+    }
+}
+}
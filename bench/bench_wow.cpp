@@ -0,0 +1,380 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <binghamton/core/lsb.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/core/stc.hpp>
+#include <binghamton/method/band.hpp>
+#include <binghamton/method/convolution.hpp>
+#include <binghamton/method/hill.hpp>
+#include <binghamton/method/simulator.hpp>
+#include <binghamton/method/video.hpp>
+#include <binghamton/method/wow.hpp>
+
+#include "bench_env.hpp"
+
+namespace binghamton {
+namespace bench {
+
+    BINGHAMTON_BENCH(wow_price)
+    {
+        // Throughput of the WOW cost map alone, from the Y plane to the quantized prices
+        for (const std::size_t _side : { 512, 1024, 2048 }) {
+            std::vector<std::uint8_t> _y, _price;
+            make_synthetic_y(_side, _side, 1, _y);
+            const double _seconds = measure_seconds([&]() {
+                price_wow(_y, _side, _side, _price);
+            });
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            report(_label, "price_throughput", 1e-6 * static_cast<double>(_side * _side) / _seconds, "MP/s");
+        }
+    }
+
+    BINGHAMTON_BENCH(cost_threads)
+    {
+        // Scaling of the tiled cost maps from one thread to the hardware concurrency
+        constexpr std::size_t _width = 4000, _height = 3000;
+        std::vector<std::uint8_t> _y, _price;
+        make_synthetic_y(_width, _height, 1, _y);
+        const std::size_t _max_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        for (std::size_t _threads = 1;; _threads = std::min(2 * _threads, _max_threads)) {
+            thread_pool _pool(_threads);
+            cost_options _options;
+            _options.pool = &_pool;
+            const double _wow_seconds = measure_seconds([&]() {
+                price_wow(_y, _width, _height, _options, _price);
+            }, 1);
+            const double _hill_seconds = measure_seconds([&]() {
+                price_hill(_y, _width, _height, _options, _price);
+            });
+            const std::string _label = "4000x3000 threads=" + std::to_string(_threads);
+            report(_label, "wow_price_throughput", 1e-6 * static_cast<double>(_width * _height) / _wow_seconds, "MP/s");
+            report(_label, "hill_price_throughput", 1e-6 * static_cast<double>(_width * _height) / _hill_seconds, "MP/s");
+            if (_threads == _max_threads) {
+                break;
+            }
+        }
+    }
+
+    BINGHAMTON_BENCH(workspace_embed)
+    {
+        // Latency of one embedding and one extraction with fresh buffers against a warm workspace
+        for (const std::size_t _side : { 512, 1024, 2048 }) {
+            std::vector<std::uint8_t> _y, _rgb, _bits, _rgb_embedded;
+            make_synthetic_y(_side, _side, 1, _y);
+            _rgb.resize(3 * _y.size());
+            for (std::size_t _index = 0; _index < _y.size(); ++_index) {
+                _rgb[3 * _index + 0] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = _y[_index];
+            }
+            make_random_bits(_y.size() / 32, 1, _bits);
+            bit_vector _payload, _payload_extracted;
+            pack_bits(_bits, _payload);
+            const std::array<std::uint8_t, 32> _key {};
+            double _cost;
+            workspace _workspace;
+            const double _fresh_seconds = measure_seconds([&]() {
+                std::vector<std::uint8_t> _fresh_rgb_embedded;
+                bit_vector _fresh_payload_extracted;
+                embed_wow(_rgb, _side, _side, _key, 4, _payload, embed_options {}, _fresh_rgb_embedded, _cost);
+                extract_wow(_fresh_rgb_embedded, _side, _side, _key, 4, _payload.size, _fresh_payload_extracted);
+            });
+            embed_wow(_rgb, _side, _side, _key, 4, _payload, embed_options {}, _workspace, _rgb_embedded, _cost);
+            const double _workspace_seconds = measure_seconds([&]() {
+                embed_wow(_rgb, _side, _side, _key, 4, _payload, embed_options {}, _workspace, _rgb_embedded, _cost);
+                extract_wow(_rgb_embedded, _side, _side, _key, 4, _payload.size, extract_options {}, _workspace, _payload_extracted);
+            });
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            report(_label, "fresh_roundtrip_latency", 1e3 * _fresh_seconds, "ms");
+            report(_label, "workspace_roundtrip_latency", 1e3 * _workspace_seconds, "ms");
+        }
+    }
+
+    BINGHAMTON_BENCH(prepared_embed)
+    {
+        // Latency of embedding in a prepared cover against a full embedding, and the part of the STC alone
+        for (const std::size_t _side : { 512, 1024, 2048 }) {
+            std::vector<std::uint8_t> _y, _rgb, _bits, _rgb_embedded;
+            make_synthetic_y(_side, _side, 1, _y);
+            _rgb.resize(3 * _y.size());
+            for (std::size_t _index = 0; _index < _y.size(); ++_index) {
+                _rgb[3 * _index + 0] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = _y[_index];
+            }
+            make_random_bits(_y.size() / 32, 1, _bits);
+            bit_vector _payload, _cover_symbols, _stego_symbols;
+            pack_bits(_bits, _payload);
+            const std::array<std::uint8_t, 32> _key {};
+            double _cost;
+            workspace _workspace;
+            prepared_cover _cover;
+            const double _prepare_seconds = measure_seconds([&]() {
+                prepare_cover<wow_cost_model>(_rgb, _side, _side, cost_options {}, _cover);
+            });
+            const double _full_seconds = measure_seconds([&]() {
+                embed_wow(_rgb, _side, _side, _key, 4, _payload, embed_options {}, _workspace, _rgb_embedded, _cost);
+            });
+            const double _prepared_seconds = measure_seconds([&]() {
+                embed_prepared(_cover, _key, 4, _payload, embed_options {}, _workspace, _rgb_embedded, _cost);
+            });
+            // The STC alone runs in the order of the permutation, which spreads the wet flat areas
+            std::vector<std::size_t> _permutation;
+            std::vector<std::uint8_t> _price_stc(_y.size());
+            make_permutation(_key, 0, _y.size(), _permutation);
+            _cover_symbols.resize(_y.size());
+            for (std::size_t _index = 0; _index < _y.size(); ++_index) {
+                _cover_symbols.set(_index, _cover.symbols.get(_permutation[_index]));
+                _price_stc[_index] = _cover.price[_permutation[_index]];
+            }
+            stc_options _options;
+            _options.wet_symbols = true;
+            const double _stc_seconds = measure_seconds([&]() {
+                encode_stc(_cover_symbols, _payload, _price_stc, 4, _options, _stego_symbols);
+            });
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            report(_label, "prepare_latency", 1e3 * _prepare_seconds, "ms");
+            report(_label, "full_embed_latency", 1e3 * _full_seconds, "ms");
+            report(_label, "prepared_embed_latency", 1e3 * _prepared_seconds, "ms");
+            report(_label, "stc_latency", 1e3 * _stc_seconds, "ms");
+        }
+    }
+
+    BINGHAMTON_BENCH(embed_stats)
+    {
+        // Latency of an embedding with and without stats, and the share of each stage
+        constexpr std::size_t _side = 2048;
+        const std::array<const char*, embed_stages_count> _stage_names = { "encode_y", "cost", "permutation", "stc", "reinjection" };
+        std::vector<std::uint8_t> _y, _rgb, _bits, _rgb_embedded;
+        make_synthetic_y(_side, _side, 1, _y);
+        _rgb.resize(3 * _y.size());
+        for (std::size_t _index = 0; _index < _y.size(); ++_index) {
+            _rgb[3 * _index + 0] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = _y[_index];
+        }
+        make_random_bits(_y.size() / 32, 1, _bits);
+        bit_vector _payload;
+        pack_bits(_bits, _payload);
+        const std::array<std::uint8_t, 32> _key {};
+        double _cost;
+        workspace _workspace;
+        embed_stats _stats;
+        embed_options _options;
+        embed_wow(_rgb, _side, _side, _key, 4, _payload, _options, _workspace, _rgb_embedded, _cost);
+        const double _plain_seconds = measure_seconds([&]() {
+            embed_wow(_rgb, _side, _side, _key, 4, _payload, _options, _workspace, _rgb_embedded, _cost);
+        });
+        _options.stats = &_stats;
+        const double _stats_seconds = measure_seconds([&]() {
+            _stats = embed_stats {};
+            embed_wow(_rgb, _side, _side, _key, 4, _payload, _options, _workspace, _rgb_embedded, _cost);
+        });
+        report("2048x2048", "plain_latency", 1e3 * _plain_seconds, "ms");
+        report("2048x2048", "stats_latency", 1e3 * _stats_seconds, "ms");
+        for (std::size_t _stage = 0; _stage < embed_stages_count; ++_stage) {
+            report("2048x2048", std::string(_stage_names[_stage]) + "_latency", 1e3 * _stats.stage_seconds[_stage], "ms");
+        }
+        report("2048x2048", "efficiency", _stats.efficiency(), "bits/change");
+    }
+
+    BINGHAMTON_BENCH(header_reject)
+    {
+        // Latency of rejecting an image without payload header against a full extraction
+        for (const std::size_t _side : { 512, 1024, 2048 }) {
+            std::vector<std::uint8_t> _y, _rgb, _bits, _rgb_embedded;
+            make_synthetic_y(_side, _side, 1, _y);
+            _rgb.resize(3 * _y.size());
+            for (std::size_t _index = 0; _index < _y.size(); ++_index) {
+                _rgb[3 * _index + 0] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = _y[_index];
+            }
+            make_random_bits(_y.size() / 32, 1, _bits);
+            bit_vector _payload, _payload_extracted;
+            pack_bits(_bits, _payload);
+            const std::array<std::uint8_t, 32> _key {};
+            double _cost;
+            workspace _workspace;
+            embed_wow(_rgb, _side, _side, _key, 4, _payload, embed_options {}, _workspace, _rgb_embedded, _cost);
+            const double _extract_seconds = measure_seconds([&]() {
+                extract_wow(_rgb_embedded, _side, _side, _key, 4, _payload.size, extract_options {}, _workspace, _payload_extracted);
+            });
+            const double _reject_seconds = measure_seconds([&]() {
+                try {
+                    extract_wow(_rgb, _side, _side, _key, 4, _payload.size, extract_options {}, _workspace, _payload_extracted);
+                } catch (const std::runtime_error&) {
+                }
+            });
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            report(_label, "extract_latency", 1e6 * _extract_seconds, "us");
+            report(_label, "reject_latency", 1e6 * _reject_seconds, "us");
+        }
+    }
+
+    BINGHAMTON_BENCH(yuv420_sequence)
+    {
+        // Frame rate of embedding in the luma planes of a frame sequence against embedding in RGB frames
+        constexpr std::size_t _width = 1280, _height = 720, _frames_count = 4;
+        std::vector<std::uint8_t> _y, _rgb, _rgb_embedded, _bits, _chroma((_width / 2) * (_height / 2), 128);
+        make_synthetic_y(_width, _height, 1, _y);
+        _rgb.resize(3 * _y.size());
+        for (std::size_t _index = 0; _index < _y.size(); ++_index) {
+            _rgb[3 * _index + 0] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = _y[_index];
+        }
+        const std::size_t _frame_bit_count = _y.size() / 32;
+        make_random_bits(_frames_count * _frame_bit_count, 1, _bits);
+        bit_vector _payload, _frame_payload;
+        pack_bits(_bits, _payload);
+        _bits.resize(_frame_bit_count);
+        pack_bits(_bits, _frame_payload);
+        const std::array<std::uint8_t, 32> _key {};
+        double _cost;
+        workspace _workspace;
+        const double _rgb_seconds = measure_seconds([&]() {
+            for (std::size_t _frame = 0; _frame < _frames_count; ++_frame) {
+                embed_wow(_rgb, _width, _height, _key, 4, _frame_payload, embed_options {}, _workspace, _rgb_embedded, _cost);
+            }
+        });
+        const double _luma_seconds = measure_seconds([&]() {
+            sequence_embedder _embedder(_key, 4, _payload, _frame_bit_count);
+            for (std::size_t _frame = 0; _frame < _frames_count; ++_frame) {
+                const yuv420_frame _yuv { _y.data(), _chroma.data(), _chroma.data(), _width, _height, _width, _width / 2 };
+                _embedder.embed_frame<wow_cost_model>(_yuv, _cost);
+            }
+        });
+        report("1280x720", "rgb_frame_rate", static_cast<double>(_frames_count) / _rgb_seconds, "fps");
+        report("1280x720", "yuv420_frame_rate", static_cast<double>(_frames_count) / _luma_seconds, "fps");
+    }
+
+    BINGHAMTON_BENCH(band_embed)
+    {
+        // Throughput and workspace size of embedding in bands of 512 rows against the whole image
+        constexpr std::size_t _width = 4096, _height = 4096;
+        std::vector<std::uint8_t> _y, _rgb, _bits, _rgb_embedded(3 * _width * _height);
+        make_synthetic_y(_width, _height, 1, _y);
+        _rgb.resize(3 * _y.size());
+        for (std::size_t _index = 0; _index < _y.size(); ++_index) {
+            _rgb[3 * _index + 0] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = _y[_index];
+        }
+        make_random_bits(_y.size() / 32, 1, _bits);
+        bit_vector _payload;
+        pack_bits(_bits, _payload);
+        const std::array<std::uint8_t, 32> _key {};
+        double _cost;
+        workspace _full_workspace, _band_workspace;
+        const double _full_seconds = measure_seconds([&]() {
+            embed_wow(_rgb, _width, _height, _key, 4, _payload, embed_options {}, _full_workspace, _rgb_embedded, _cost);
+        }, 1);
+        const band_reader _read = [&](const std::size_t _first_row, const mutable_image_view& _rows) {
+            std::memcpy(_rows.data, _rgb.data() + 3 * _width * _first_row, 3 * _width * _rows.height);
+        };
+        const band_writer _write = [&](const std::size_t _first_row, const image_view& _rows) {
+            std::memcpy(_rgb_embedded.data() + 3 * _width * _first_row, _rows.data, 3 * _width * _rows.height);
+        };
+        const double _band_seconds = measure_seconds([&]() {
+            embed_bands<wow_cost_model>(_width, _height, _key, 4, _payload, band_options {}, embed_options {}, _band_workspace, _read, _write, _cost);
+        }, 1);
+        report("4096x4096", "full_throughput", 1e-6 * static_cast<double>(_width * _height) / _full_seconds, "MP/s");
+        report("4096x4096", "band_throughput", 1e-6 * static_cast<double>(_width * _height) / _band_seconds, "MP/s");
+        report("4096x4096", "full_workspace", 1e-6 * static_cast<double>(_full_workspace.capacity()), "MB");
+        report("4096x4096", "band_workspace", 1e-6 * static_cast<double>(_band_workspace.capacity()), "MB");
+    }
+
+    BINGHAMTON_BENCH(simulator)
+    {
+        // Latency of a simulated embedding against the STC embedding of the same prepared cover, and of
+        // solving lambda alone
+        for (const std::size_t _side : { 512, 1024, 2048 }) {
+            std::vector<std::uint8_t> _y, _rgb, _bits, _rgb_embedded;
+            make_synthetic_y(_side, _side, 1, _y);
+            _rgb.resize(3 * _y.size());
+            for (std::size_t _index = 0; _index < _y.size(); ++_index) {
+                _rgb[3 * _index + 0] = _rgb[3 * _index + 1] = _rgb[3 * _index + 2] = _y[_index];
+            }
+            make_random_bits(_y.size() / 32, 1, _bits);
+            bit_vector _payload;
+            pack_bits(_bits, _payload);
+            prepared_cover _cover;
+            prepare_cover<wow_cost_model>(_rgb, _side, _side, cost_options {}, _cover);
+            workspace _workspace;
+            double _cost;
+            gibbs_embedding _embedding;
+            const double _stc_seconds = measure_seconds([&]() {
+                embed_prepared(_cover, std::array<std::uint8_t, 32> {}, 7, _payload, embed_options {}, _workspace, _rgb_embedded, _cost);
+            });
+            const double _simulated_seconds = measure_seconds([&]() {
+                simulate_embedding(_cover, _payload.size, 1, _rgb_embedded, _embedding);
+            });
+            const double _solve_seconds = measure_seconds([&]() {
+                solve_gibbs_payload(_cover.price.data(), _cover.price.size(), static_cast<double>(_payload.size), _embedding);
+            });
+            const std::string _label = std::to_string(_side) + "x" + std::to_string(_side);
+            report(_label, "stc_embed_latency", 1e3 * _stc_seconds, "ms");
+            report(_label, "simulated_embed_latency", 1e3 * _simulated_seconds, "ms");
+            report(_label, "solve_latency", 1e3 * _solve_seconds, "ms");
+            report(_label, "stc_distortion_ratio", _cost / _embedding.distortion, "x");
+        }
+    }
+
+    BINGHAMTON_BENCH(convolution)
+    {
+        // Direct against fft correlation per kernel length, the crossover sets the automatic threshold
+        constexpr std::size_t _side = 1024;
+        std::mt19937 _generator(1);
+        std::uniform_real_distribution<float> _distribution(-1.0f, 1.0f);
+        for (const std::size_t _taps_count : { 8, 16, 32, 48, 64, 128, 256 }) {
+            std::vector<float> _taps(_taps_count), _input((_side + _taps_count) * (_side + _taps_count)), _output(_side * _side);
+            for (float& _tap : _taps) {
+                _tap = _distribution(_generator);
+            }
+            for (float& _sample : _input) {
+                _sample = _distribution(_generator);
+            }
+            const std::size_t _stride = _side + _taps_count;
+            const std::string _label = "1024x1024 taps=" + std::to_string(_taps_count);
+            for (const convolution_method _method : { convolution_method::direct, convolution_method::fft }) {
+                const std::string _name = _method == convolution_method::direct ? "direct" : "fft";
+                const double _rows_seconds = measure_seconds([&]() {
+                    correlate_rows(_input.data(), _stride, _side, _side, _taps, _output.data(), _side, _method);
+                });
+                const double _columns_seconds = measure_seconds([&]() {
+                    correlate_columns(_input.data(), _stride, _side, _side, _taps, _output.data(), _side, _method);
+                });
+                report(_label, _name + "_rows_throughput", 1e-6 * static_cast<double>(_side * _side) / _rows_seconds, "MP/s");
+                report(_label, _name + "_columns_throughput", 1e-6 * static_cast<double>(_side * _side) / _columns_seconds, "MP/s");
+            }
+        }
+
+        // One separable 16x16 filter against its naive two-dimensional evaluation
+        std::vector<float> _taps(16), _kernel(256), _input((_side + 16) * (_side + 16)), _temporary(_side * (_side + 16)), _output(_side * _side);
+        for (float& _tap : _taps) {
+            _tap = _distribution(_generator);
+        }
+        for (std::size_t _index = 0; _index < 256; ++_index) {
+            _kernel[_index] = _taps[_index / 16] * _taps[_index % 16];
+        }
+        for (float& _sample : _input) {
+            _sample = _distribution(_generator);
+        }
+        const std::size_t _stride = _side + 16;
+        const double _naive_seconds = measure_seconds([&]() {
+            for (std::size_t _row = 0; _row < _side; ++_row) {
+                for (std::size_t _column = 0; _column < _side; ++_column) {
+                    float _sum = 0.0f;
+                    for (std::size_t _k = 0; _k < 16; ++_k) {
+                        for (std::size_t _l = 0; _l < 16; ++_l) {
+                            _sum += _kernel[_k * 16 + _l] * _input[(_row + _k) * _stride + _column + _l];
+                        }
+                    }
+                    _output[_row * _side + _column] = _sum;
+                }
+            }
+        }, 1);
+        const double _separable_seconds = measure_seconds([&]() {
+            correlate_columns(_input.data(), _stride, _stride, _side, _taps, _temporary.data(), _stride);
+            correlate_rows(_temporary.data(), _stride, _side, _side, _taps, _output.data(), _side);
+        });
+        report("1024x1024 16x16", "naive_2d_throughput", 1e-6 * static_cast<double>(_side * _side) / _naive_seconds, "MP/s");
+        report("1024x1024 16x16", "separable_throughput", 1e-6 * static_cast<double>(_side * _side) / _separable_seconds, "MP/s");
+    }
+
+}
+}
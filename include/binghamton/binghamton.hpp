@@ -1,7 +1,23 @@
 #pragma once
 
+#include <binghamton/core/bits.hpp>
+#include <binghamton/core/image.hpp>
 #include <binghamton/core/lsb.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/core/scratch.hpp>
 #include <binghamton/core/stc.hpp>
+#include <binghamton/core/thread_pool.hpp>
 #include <binghamton/core/ycbcr.hpp>
 
+#include <binghamton/method/band.hpp>
+#include <binghamton/method/batch.hpp>
+#include <binghamton/method/convolution.hpp>
+#include <binghamton/method/cost.hpp>
+#include <binghamton/method/hill.hpp>
+#include <binghamton/method/pipeline.hpp>
+#include <binghamton/method/simulator.hpp>
+#include <binghamton/method/suniward.hpp>
+#include <binghamton/method/video.hpp>
+#include <binghamton/method/wavelet.hpp>
+#include <binghamton/method/workspace.hpp>
 #include <binghamton/method/wow.hpp>
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/// @brief Marks a pointer parameter as the only way to reach its memory, for compilers that know restrict
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define BINGHAMTON_RESTRICT __restrict
+#else
+#define BINGHAMTON_RESTRICT
+#endif
+
+namespace binghamton {
+
+/// @brief Counts the bits set in a word
+/// @param word the word
+inline std::uint32_t popcount(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::uint32_t>(__builtin_popcountll(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555u);
+    word = (word & 0x3333333333333333u) + ((word >> 2) & 0x3333333333333333u);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+    return static_cast<std::uint32_t>((word * 0x0101010101010101u) >> 56);
+#endif
+}
+
+/// @brief Gets the parity of a word, 1 when it has an odd count of bits set
+/// @param word the word
+inline std::uint32_t parity(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::uint32_t>(__builtin_parityll(word));
+#else
+    word ^= word >> 32;
+    word ^= word >> 16;
+    word ^= word >> 8;
+    word ^= word >> 4;
+    return (0x6996u >> (word & 15u)) & 1u;
+#endif
+}
+
+/// @brief Counts the zero bits below the lowest bit set of a word
+/// @param word the word, that must not be zero
+inline std::uint32_t count_trailing_zeros(const std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::uint32_t>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long _index;
+    _BitScanForward64(&_index, word);
+    return static_cast<std::uint32_t>(_index);
+#else
+    return popcount((word & (0 - word)) - 1u);
+#endif
+}
+
+/// @brief Bits packed 64 per word, bit i is bit i % 64 of word i / 64 and the unused bits of the last word are zero.
+/// The words come from the default memory resource unless constructed with another one.
+struct bit_vector {
+    std::pmr::vector<std::uint64_t> words;
+    std::size_t size = 0;
+
+    /// @brief Resizes the vector, added bits are zero
+    /// @param count the new count of bits
+    void resize(const std::size_t count);
+
+    /// @brief Gets one bit
+    /// @param index the index of the bit
+    bool get(const std::size_t index) const
+    {
+        return (words[index / 64] >> (index % 64)) & 1u;
+    }
+
+    /// @brief Sets one bit
+    /// @param index the index of the bit
+    /// @param value the value of the bit
+    void set(const std::size_t index, const bool value)
+    {
+        const std::uint64_t _mask = std::uint64_t(1) << (index % 64);
+        words[index / 64] = value ? (words[index / 64] | _mask) : (words[index / 64] & ~_mask);
+    }
+};
+
+/// @brief Packs bits stored one per byte
+/// @param bits the bits to take as input, only the LSB of each byte is read
+/// @param packed the packed bits to take as output
+void pack_bits(
+    const std::vector<std::uint8_t>& bits,
+    bit_vector& packed);
+
+/// @brief Unpacks bits to one per byte
+/// @param packed the packed bits to take as input
+/// @param bits the bits to take as output, one per byte
+void unpack_bits(
+    const bit_vector& packed,
+    std::vector<std::uint8_t>& bits);
+
+/// @brief Computes the CRC-32 (IEEE 802.3) of packed bits, over the (size + 7) / 8 bytes of the little-endian
+/// words, the bits past the size being zero
+/// @param packed the packed bits
+std::uint32_t crc32(const bit_vector& packed);
+
+}
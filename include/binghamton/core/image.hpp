@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace binghamton {
+
+/// @brief Order and count of the 8-bit channels of a pixel
+enum struct pixel_layout {
+
+    /// @brief Red, green and blue
+    rgb,
+
+    /// @brief Blue, green and red
+    bgr,
+
+    /// @brief Red, green, blue and an alpha channel left untouched
+    rgba,
+
+    /// @brief Blue, green, red and an alpha channel left untouched
+    bgra,
+
+    /// @brief One channel, taken as Y without colour conversion
+    gray
+};
+
+/// @brief Gets the count of channels of a pixel layout
+/// @param layout the pixel layout
+std::size_t channels_count(const pixel_layout layout);
+
+/// @brief Non-owning view of read-only pixels, the buffer must outlive the view
+struct image_view {
+    const std::uint8_t* data = nullptr;
+    std::size_t width = 0;
+    std::size_t height = 0;
+
+    /// @brief The count of bytes between the first pixels of two rows, at least width * channels_count(layout)
+    std::size_t stride = 0;
+
+    pixel_layout layout = pixel_layout::rgb;
+};
+
+/// @brief Non-owning view of writable pixels, the buffer must outlive the view
+struct mutable_image_view {
+    std::uint8_t* data = nullptr;
+    std::size_t width = 0;
+    std::size_t height = 0;
+
+    /// @brief The count of bytes between the first pixels of two rows, at least width * channels_count(layout)
+    std::size_t stride = 0;
+
+    pixel_layout layout = pixel_layout::rgb;
+
+    operator image_view() const { return image_view { data, width, height, stride, layout }; }
+};
+
+/// @brief Views tightly packed pixels
+/// @param pixels the pixels, width * height * channels_count(layout) of them
+/// @param width the width of the image
+/// @param height the height of the image
+/// @param layout the pixel layout
+image_view make_image_view(
+    const std::vector<std::uint8_t>& pixels,
+    const std::size_t width,
+    const std::size_t height,
+    const pixel_layout layout = pixel_layout::rgb);
+
+/// @brief Views tightly packed pixels
+/// @param pixels the pixels, width * height * channels_count(layout) of them
+/// @param width the width of the image
+/// @param height the height of the image
+/// @param layout the pixel layout
+mutable_image_view make_image_view(
+    std::vector<std::uint8_t>& pixels,
+    const std::size_t width,
+    const std::size_t height,
+    const pixel_layout layout = pixel_layout::rgb);
+
+/// @brief Tells whether a view has pixels and rows long enough for its width and layout
+/// @param image the view
+bool is_valid(const image_view& image);
+
+/// @brief Tells whether the rows of a view follow each other without padding
+/// @param image the view
+bool is_packed(const image_view& image);
+
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+#include <binghamton/core/bits.hpp>
+
 namespace binghamton {
 
 /// @brief 
@@ -12,6 +15,22 @@ void encode_lsb(
     const std::vector<std::uint8_t>& y,
     std::vector<std::uint8_t>& y_lsb);
 
+/// @brief Extracts the LSB plane of Y pixels packed 64 pixels per word
+/// @param y the Y pixels to take as input
+/// @param y_lsb the packed LSB plane to take as output
+void encode_lsb(
+    const std::vector<std::uint8_t>& y,
+    bit_vector& y_lsb);
+
+/// @brief Extracts the LSB plane of Y pixels packed 64 pixels per word
+/// @param y the Y pixels to take as input, pixels_count of them
+/// @param pixels_count the count of pixels
+/// @param y_lsb the packed LSB plane to take as output
+void encode_lsb(
+    const std::uint8_t* y,
+    const std::size_t pixels_count,
+    bit_vector& y_lsb);
+
 /// @brief 
 /// @param y 
 /// @param y_lsb 
@@ -20,4 +39,22 @@ void decode_lsb(
     const std::vector<std::uint8_t>& y_lsb,
     std::vector<std::uint8_t>& y_embedded);
 
-}
\ No newline at end of file
+/// @brief Replaces the LSB plane of Y pixels with a packed LSB plane
+/// @param y the Y pixels to take as input
+/// @param y_lsb the packed LSB plane to take as input
+/// @param y_embedded the Y pixels modified by the LSB plane
+void decode_lsb(
+    const std::vector<std::uint8_t>& y,
+    const bit_vector& y_lsb,
+    std::vector<std::uint8_t>& y_embedded);
+
+/// @brief Replaces the LSB plane of Y pixels with a packed LSB plane
+/// @param y the Y pixels to take as input, y_lsb.size of them
+/// @param y_lsb the packed LSB plane to take as input
+/// @param y_embedded the Y pixels modified by the LSB plane, y_lsb.size of them
+void decode_lsb(
+    const std::uint8_t* y,
+    const bit_vector& y_lsb,
+    std::uint8_t* y_embedded);
+
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace binghamton {
+
+/// @brief Algorithm mapping the payload positions to the pixels, the extraction must use the one of the embedding
+enum struct permutation_version {
+
+    /// @brief Fisher-Yates shuffle of a table of indices, 8 bytes per pixel computed serially, as the
+    /// first stego images were embedded
+    shuffle,
+
+    /// @brief Keyed Feistel network with cycle-walking, any index mapped in constant time and memory
+    feistel,
+
+    /// @brief Table of the blocks of pixels in keyed order, each one shuffled inside, so that consecutive
+    /// payload positions stay in a block fitting the L2 cache
+    blocked
+};
+
+/// @brief Count of pixels per block of the blocked permutation, 64 KiB of Y and of prices
+constexpr std::size_t permutation_block_size = std::size_t(1) << 16;
+
+/// @brief Key-dependent bijection of the pixel indices [first, first + count) computed per index without
+/// a table, a balanced Feistel network over the smallest even power of two covering count and cycle-walking
+/// the indices it maps past count
+class feistel_permutation {
+public:
+    /// @brief Derives the round keys of a permutation
+    /// @param steg_key the key of the permutation
+    /// @param first the first pixel index of the range
+    /// @param count the count of pixel indices of the range
+    feistel_permutation(
+        const std::array<std::uint8_t, 32>& steg_key,
+        const std::size_t first,
+        const std::size_t count);
+
+    /// @brief Gets the pixel index at a position, in any order and from any thread
+    /// @param index the position, smaller than count
+    /// @return the pixel index in [first, first + count)
+    std::size_t operator()(const std::size_t index) const
+    {
+        std::uint64_t _value = index;
+        do {
+            _value = _encrypt(_value);
+        } while (_value >= _count);
+        return _first + static_cast<std::size_t>(_value);
+    }
+
+    /// @brief Gets the count of pixel indices of the range
+    std::size_t size() const { return static_cast<std::size_t>(_count); }
+
+private:
+    static constexpr std::size_t rounds_count = 6;
+
+    std::uint64_t _encrypt(const std::uint64_t value) const
+    {
+        std::uint64_t _left = value >> _half_bits, _right = value & _half_mask;
+        for (const std::uint64_t _round_key : _round_keys) {
+            // Murmur3 finalizer of the keyed right half
+            std::uint64_t _mixed = _right ^ _round_key;
+            _mixed = (_mixed ^ (_mixed >> 33)) * 0xff51afd7ed558ccdULL;
+            _mixed = (_mixed ^ (_mixed >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+            _mixed ^= _mixed >> 33;
+            const std::uint64_t _next = (_left ^ _mixed) & _half_mask;
+            _left = _right;
+            _right = _next;
+        }
+        return (_left << _half_bits) | _right;
+    }
+
+    std::size_t _first;
+    std::uint64_t _count;
+    unsigned _half_bits;
+    std::uint64_t _half_mask;
+    std::array<std::uint64_t, rounds_count> _round_keys;
+};
+
+/// @brief Computes the key-dependent permutation of a range of pixel indices
+/// @param steg_key the key seeding the shuffle
+/// @param first the first pixel index of the range
+/// @param count the count of pixel indices of the range
+/// @param indices_out the pixel indices [first, first + count) in permuted order
+void make_permutation(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t first,
+    const std::size_t count,
+    std::vector<std::size_t>& indices_out);
+
+/// @brief Computes the key-dependent permutation of a range of pixel indices
+/// @param steg_key the key seeding the shuffle
+/// @param first the first pixel index of the range
+/// @param count the count of pixel indices of the range
+/// @param indices_out the pixel indices [first, first + count) in permuted order, count of them
+void make_permutation(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t first,
+    const std::size_t count,
+    std::size_t* indices_out);
+
+/// @brief Computes the key-dependent blocked permutation of a range of pixel indices. The blocks of
+/// block_size pixels are ordered by a feistel network, then the pixels of each one are shuffled. The last
+/// block, shorter, stays last.
+/// @param steg_key the key seeding the block order and the shuffles
+/// @param first the first pixel index of the range
+/// @param count the count of pixel indices of the range
+/// @param indices_out the pixel indices [first, first + count) in permuted order, count of them
+/// @param block_size the count of pixels per block
+void make_blocked_permutation(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t first,
+    const std::size_t count,
+    std::size_t* indices_out,
+    const std::size_t block_size = permutation_block_size);
+
+/// @brief Computes a key-dependent stream of random words, seeded apart from the permutations so that
+/// both never correlate
+/// @param steg_key the key seeding the stream
+/// @param count the count of words
+/// @param words_out the words of the stream, count of them
+void make_key_stream(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t count,
+    std::uint64_t* words_out);
+
+/// @brief Thread-safe cache of permutations shared between images with the same key and size
+class permutation_cache {
+public:
+    /// @brief Creates an empty cache
+    /// @param byte_limit the upper bound in bytes of the cached tables, 0 for no bound. Past it the least
+    /// recently used tables are dropped, those still held by a caller stay alive until released.
+    explicit permutation_cache(const std::size_t byte_limit = 0);
+
+    /// @brief Gets the permutation of a range of pixel indices, computing it on first use. Concurrent
+    /// requests of the same permutation compute it once and wait for it.
+    /// @param steg_key the key seeding the shuffle
+    /// @param first the first pixel index of the range
+    /// @param count the count of pixel indices of the range
+    /// @param version the permutation, shuffle or blocked
+    /// @return the pixel indices [first, first + count) in permuted order, valid as long as the cache
+    std::shared_ptr<const std::vector<std::size_t>> get(
+        const std::array<std::uint8_t, 32>& steg_key,
+        const std::size_t first,
+        const std::size_t count,
+        const permutation_version version = permutation_version::shuffle);
+
+    /// @brief Gets the count of cached permutations
+    std::size_t size() const;
+
+    /// @brief Gets the size in bytes of the cached tables
+    std::size_t bytes() const;
+
+    /// @brief Drops every cached permutation
+    void clear();
+
+private:
+    struct entry;
+    using key_type = std::tuple<std::array<std::uint8_t, 32>, std::size_t, std::size_t, permutation_version>;
+
+    std::map<key_type, std::shared_ptr<entry>> _entries;
+    std::size_t _byte_limit;
+    std::size_t _bytes = 0;
+    std::uint64_t _uses_count = 0;
+    mutable std::mutex _mutex;
+};
+
+}
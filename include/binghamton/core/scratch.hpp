@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory_resource>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace binghamton {
+
+/// @brief Alignment in bytes of every scratch buffer, a cache line
+constexpr std::size_t scratch_alignment = 64;
+
+/// @brief Numbered buffers kept between calls, each one growing to the largest size requested, so that
+/// calls no larger than the previous ones do not allocate
+class scratch {
+public:
+    /// @brief Creates a scratch without buffers
+    /// @param resource the memory resource of the buffers
+    explicit scratch(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    scratch(const scratch& other) = delete;
+    scratch& operator=(const scratch& other) = delete;
+    ~scratch();
+
+    /// @brief Gets a buffer, reallocating it when it is smaller than requested. The values are
+    /// uninitialized, and are lost when the buffer grows.
+    /// @tparam value_t a trivially copyable type aligned to at most scratch_alignment
+    /// @param index the index of the buffer, two indices never share memory
+    /// @param count the count of values needed
+    /// @return the first value, aligned to scratch_alignment
+    template <typename value_t>
+    value_t* get(const std::size_t index, const std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<value_t>, "scratch: value_t must be trivially copyable");
+        static_assert(alignof(value_t) <= scratch_alignment, "scratch: value_t is over-aligned");
+        return static_cast<value_t*>(_get(index, count * sizeof(value_t)));
+    }
+
+    /// @brief Gets the count of bytes held by the buffers
+    std::size_t capacity() const;
+
+    /// @brief Gets the memory resource of the buffers
+    std::pmr::memory_resource* resource() const;
+
+    /// @brief Frees every buffer
+    void release();
+
+private:
+    struct buffer {
+        void* data = nullptr;
+        std::size_t bytes = 0;
+    };
+
+    void* _get(const std::size_t index, const std::size_t bytes);
+
+    std::pmr::memory_resource* _resource;
+    std::pmr::vector<buffer> _buffers;
+};
+
+/// @brief Scratches lent to tasks running at the same time, each running task holding its own. The
+/// pool keeps as many scratches as tasks ever ran at once.
+class scratch_pool {
+public:
+    /// @brief Scratch lent to one task, given back to the pool on destruction
+    class lease {
+    public:
+        lease(lease&& other) noexcept;
+        lease(const lease& other) = delete;
+        lease& operator=(const lease& other) = delete;
+        ~lease();
+
+        scratch& operator*() const { return *_scratch; }
+        scratch* operator->() const { return _scratch; }
+
+    private:
+        friend class scratch_pool;
+        lease(scratch_pool* pool, scratch* value);
+
+        scratch_pool* _pool;
+        scratch* _scratch;
+    };
+
+    /// @brief Creates a pool without scratches
+    /// @param resource the memory resource of the scratches
+    explicit scratch_pool(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    scratch_pool(const scratch_pool& other) = delete;
+    scratch_pool& operator=(const scratch_pool& other) = delete;
+
+    /// @brief Lends a scratch no other lease holds, the one given back last if any. Thread-safe.
+    lease acquire();
+
+    /// @brief Gets the count of bytes held by the scratches
+    std::size_t capacity() const;
+
+    /// @brief Gets the memory resource of the scratches
+    std::pmr::memory_resource* resource() const;
+
+    /// @brief Frees the buffers of every scratch, no lease may be held
+    void release();
+
+private:
+    std::pmr::memory_resource* _resource;
+    std::pmr::list<scratch> _scratches;
+    std::pmr::vector<scratch*> _available;
+    mutable std::mutex _mutex;
+};
+
+}
@@ -1,16 +1,54 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+#include <binghamton/core/bits.hpp>
+#include <binghamton/core/scratch.hpp>
+#include <binghamton/core/thread_pool.hpp>
+
 namespace binghamton {
-    
-/// @brief
+
+/// @brief Price of a wet symbol when stc_options::wet_symbols is set, the encoder then never changes it
+constexpr std::uint8_t wet_price = 255;
+
+/// @brief Options of the syndrome-trellis encoder
+struct stc_options {
+
+    /// @brief Upper bound in bytes of the survivor path memory, 0 keeps the paths of every column.
+    /// The paths of a full trellis take n * 2^h bits. Under a smaller bound the encoder only
+    /// checkpoints the trellis costs at segment boundaries and recomputes the paths of each
+    /// segment while back-tracking, trading up to one extra forward pass for memory. The stego
+    /// symbols are identical whatever the bound.
+    std::size_t path_memory_limit = 0;
+
+    /// @brief Count of independent codes the cover and the syndrome are split into, 1 for a single code.
+    /// Each segment is coded by its own trellis and can run on its own thread, at the price of a slightly
+    /// higher distortion near segment ends. The decoder must be given the same segment count, the
+    /// segmentation then only depends on the payload length. The path memory limit applies per segment.
+    std::size_t segment_count = 1;
+
+    /// @brief Whether symbols priced wet_price are wet, the encoder then never changes them and fails when
+    /// the dry symbols cannot carry the syndrome. Left unset, every price from 0 to 255 is a finite price.
+    bool wet_symbols = false;
+
+    /// @brief Pool running the segments in parallel, nullptr runs them on the calling thread. The result
+    /// does not depend on the pool size.
+    thread_pool* pool = nullptr;
+
+    /// @brief Scratch memory of the trellises kept between calls, nullptr allocates it for the call. Coding
+    /// again a cover length and a message length already met then does not allocate.
+    scratch_pool* scratch = nullptr;
+};
+
+/// @brief Embeds syndrome bits in cover symbols with a syndrome-trellis code minimizing the total price of changes
 /// @param cover_symbols the binary cover data
 /// @param syndrome_bits the binary message to be hidden
 /// @param pricevector the vector of distortion weights
-/// @param constraint_height the constraint height of the matrix
+/// @param constraint_height the constraint height of the matrix, from 1 to 15, or 0 for the legacy block parity code
 /// @param stego_symbols the computed stego data
+/// @return the total price of the changed symbols
 double encode_stc(
     const std::vector<std::uint8_t>& cover_symbols,
     const std::vector<std::uint8_t>& syndrome_bits,
@@ -18,15 +56,114 @@ double encode_stc(
     const std::uint32_t constraint_height,
     std::vector<std::uint8_t>& stego_symbols);
 
-/// @brief
-/// @param stego_symbols
-/// @param constraint_height
-/// @param payload_bit_count
-/// @param payload_bits_out
+/// @brief Embeds syndrome bits in cover symbols with a syndrome-trellis code minimizing the total price of changes
+/// @param cover_symbols the binary cover data
+/// @param syndrome_bits the binary message to be hidden
+/// @param pricevector the vector of distortion weights
+/// @param constraint_height the constraint height of the matrix, from 1 to 15, or 0 for the legacy block parity code
+/// @param options the encoder options
+/// @param stego_symbols the computed stego data
+/// @return the total price of the changed symbols
+double encode_stc(
+    const std::vector<std::uint8_t>& cover_symbols,
+    const std::vector<std::uint8_t>& syndrome_bits,
+    const std::vector<std::uint8_t>& pricevector,
+    const std::uint32_t constraint_height,
+    const stc_options& options,
+    std::vector<std::uint8_t>& stego_symbols);
+
+/// @brief Embeds syndrome bits in bit-packed cover symbols with a syndrome-trellis code minimizing the total price of changes
+/// @param cover_symbols the packed binary cover data
+/// @param syndrome_bits the packed binary message to be hidden
+/// @param pricevector the vector of distortion weights, one per cover symbol
+/// @param constraint_height the constraint height of the matrix, from 1 to 15, or 0 for the legacy block parity code
+/// @param stego_symbols the computed packed stego data
+/// @return the total price of the changed symbols
+double encode_stc(
+    const bit_vector& cover_symbols,
+    const bit_vector& syndrome_bits,
+    const std::vector<std::uint8_t>& pricevector,
+    const std::uint32_t constraint_height,
+    bit_vector& stego_symbols);
+
+/// @brief Embeds syndrome bits in bit-packed cover symbols with a syndrome-trellis code minimizing the total price of changes
+/// @param cover_symbols the packed binary cover data
+/// @param syndrome_bits the packed binary message to be hidden
+/// @param pricevector the vector of distortion weights, one per cover symbol
+/// @param constraint_height the constraint height of the matrix, from 1 to 15, or 0 for the legacy block parity code
+/// @param options the encoder options
+/// @param stego_symbols the computed packed stego data
+/// @return the total price of the changed symbols
+double encode_stc(
+    const bit_vector& cover_symbols,
+    const bit_vector& syndrome_bits,
+    const std::vector<std::uint8_t>& pricevector,
+    const std::uint32_t constraint_height,
+    const stc_options& options,
+    bit_vector& stego_symbols);
+
+/// @brief Embeds syndrome bits in bit-packed cover symbols with a syndrome-trellis code minimizing the total price of changes
+/// @param cover_symbols the packed binary cover data
+/// @param syndrome_bits the packed binary message to be hidden
+/// @param pricevector the distortion weights, cover_symbols.size of them
+/// @param constraint_height the constraint height of the matrix, from 1 to 15, or 0 for the legacy block parity code
+/// @param options the encoder options
+/// @param stego_symbols the computed packed stego data
+/// @return the total price of the changed symbols
+double encode_stc(
+    const bit_vector& cover_symbols,
+    const bit_vector& syndrome_bits,
+    const std::uint8_t* pricevector,
+    const std::uint32_t constraint_height,
+    const stc_options& options,
+    bit_vector& stego_symbols);
+
+/// @brief Computes the syndrome bits carried by stego symbols
+/// @param stego_symbols the binary stego data
+/// @param constraint_height the constraint height used by encode_stc
+/// @param payload_bit_count the count of syndrome bits to compute
+/// @param syndrome_bits_out the computed syndrome bits
+void decode_stc(
+    const std::vector<std::uint8_t>& stego_symbols,
+    const std::uint32_t constraint_height,
+    const std::size_t payload_bit_count,
+    std::vector<std::uint8_t>& syndrome_bits_out);
+
+/// @brief Computes the syndrome bits carried by stego symbols
+/// @param stego_symbols the binary stego data
+/// @param constraint_height the constraint height used by encode_stc
+/// @param payload_bit_count the count of syndrome bits to compute
+/// @param options the options used by encode_stc
+/// @param syndrome_bits_out the computed syndrome bits
 void decode_stc(
     const std::vector<std::uint8_t>& stego_symbols,
     const std::uint32_t constraint_height,
     const std::size_t payload_bit_count,
+    const stc_options& options,
     std::vector<std::uint8_t>& syndrome_bits_out);
 
-}
\ No newline at end of file
+/// @brief Computes the syndrome bits carried by bit-packed stego symbols, 64 symbols at a time
+/// @param stego_symbols the packed binary stego data
+/// @param constraint_height the constraint height used by encode_stc
+/// @param payload_bit_count the count of syndrome bits to compute
+/// @param syndrome_bits_out the computed packed syndrome bits
+void decode_stc(
+    const bit_vector& stego_symbols,
+    const std::uint32_t constraint_height,
+    const std::size_t payload_bit_count,
+    bit_vector& syndrome_bits_out);
+
+/// @brief Computes the syndrome bits carried by bit-packed stego symbols, 64 symbols at a time
+/// @param stego_symbols the packed binary stego data
+/// @param constraint_height the constraint height used by encode_stc
+/// @param payload_bit_count the count of syndrome bits to compute
+/// @param options the options used by encode_stc
+/// @param syndrome_bits_out the computed packed syndrome bits
+void decode_stc(
+    const bit_vector& stego_symbols,
+    const std::uint32_t constraint_height,
+    const std::size_t payload_bit_count,
+    const stc_options& options,
+    bit_vector& syndrome_bits_out);
+
+}
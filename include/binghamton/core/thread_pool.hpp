@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace binghamton {
+
+/// @brief Fixed set of worker threads running parallel loops
+class thread_pool {
+public:
+    /// @brief Starts the worker threads
+    /// @param thread_count the count of threads running a loop, including the calling thread, 0 for the hardware concurrency
+    explicit thread_pool(const std::size_t thread_count = 0);
+    thread_pool(const thread_pool& other) = delete;
+    thread_pool& operator=(const thread_pool& other) = delete;
+    ~thread_pool();
+
+    /// @brief Gets the count of threads running a loop, including the calling thread
+    std::size_t size() const;
+
+    /// @brief Runs a function for every index of a range and waits for all of them. The calling thread
+    /// takes part in the loop so that loops can be nested from inside the pool without deadlocking.
+    /// The first exception thrown by the function is rethrown once every index ran.
+    /// @param count the count of indices to run
+    /// @param function the function to run for every index in [0, count)
+    void parallel_for(
+        const std::size_t count,
+        const std::function<void(std::size_t)>& function);
+
+private:
+    struct job;
+
+    void _work();
+
+    std::vector<std::thread> _workers;
+    std::deque<std::shared_ptr<job>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+};
+
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+#include <binghamton/core/bits.hpp>
+#include <binghamton/core/image.hpp>
+
 namespace binghamton {
 
 /// @brief Encodes RGB pixels to BT.601 Y pixels to separate luminance
@@ -12,6 +16,22 @@ void encode_y(
     const std::vector<std::uint8_t>& rgb,
     std::vector<std::uint8_t>& y);
 
+/// @brief Encodes RGB pixels to BT.601 Y pixels to separate luminance
+/// @param rgb the RGB pixels to take as input, 3 * pixels_count of them
+/// @param pixels_count the count of pixels
+/// @param y the Y pixels to take as output, pixels_count of them
+void encode_y(
+    const std::uint8_t* rgb,
+    const std::size_t pixels_count,
+    std::uint8_t* y);
+
+/// @brief Encodes the pixels of an image to BT.601 Y pixels, a gray image being copied as is
+/// @param image the pixels to take as input
+/// @param y the Y pixels to take as output, image.width * image.height of them without padding
+void encode_y(
+    const image_view& image,
+    std::uint8_t* y);
+
 /// @brief Decodes RGB pixels from BT.601 Y pixels and original pixels
 /// @param rgb the original RGB pixels to take as input
 /// @param y the Y pixels to take as input
@@ -21,4 +41,86 @@ bool decode_y(
     const std::vector<std::uint8_t>& y,
     std::vector<std::uint8_t>& rgb_embedded);
 
+/// @brief Decodes RGB pixels from BT.601 Y pixels and original pixels
+/// @param rgb the original RGB pixels to take as input, 3 * pixels_count of them
+/// @param y the Y pixels to take as input, pixels_count of them
+/// @param pixels_count the count of pixels
+/// @param rgb_embedded the RGB pixels modified by the Y pixels, 3 * pixels_count of them
+bool decode_y(
+    const std::uint8_t* rgb,
+    const std::uint8_t* y,
+    const std::size_t pixels_count,
+    std::uint8_t* rgb_embedded);
+
+/// @brief Extracts the LSB plane of the BT.601 Y of RGB pixels in one pass, packed 64 pixels per word
+/// @param rgb the RGB pixels to take as input, 3 * pixels_count of them
+/// @param pixels_count the count of pixels
+/// @param y_lsb the packed LSB plane to take as output
+void encode_y_lsb(
+    const std::uint8_t* rgb,
+    const std::size_t pixels_count,
+    bit_vector& y_lsb);
+
+/// @brief Extracts the LSB plane of the BT.601 Y of the pixels of an image in one pass, packed 64 pixels per word
+/// @param image the pixels to take as input
+/// @param y_lsb the packed LSB plane to take as output, image.width * image.height bits
+void encode_y_lsb(
+    const image_view& image,
+    bit_vector& y_lsb);
+
+/// @brief Flips the LSB of the BT.601 Y of the flagged RGB pixels, adding 1 to R, G and B when the LSB is
+/// 0 and subtracting 1 otherwise, as decode_lsb then decode_y would. A pixel that would leave the RGB range
+/// moves the other way, which flips the LSB as well. The other pixels are only copied.
+/// @param rgb the original RGB pixels to take as input, 3 * y_lsb_flips.size of them
+/// @param y_lsb_flips the packed plane flagging the pixels to flip
+/// @param rgb_embedded the RGB pixels with flipped Y LSBs, 3 * y_lsb_flips.size of them, may be rgb to
+/// flip in place
+/// @return false, with rgb_embedded holding the original pixels, when a flagged pixel is clipping
+bool decode_y_lsb(
+    const std::uint8_t* rgb,
+    const bit_vector& y_lsb_flips,
+    std::uint8_t* rgb_embedded);
+
+/// @brief Flips the LSB of the BT.601 Y of the flagged pixels of an image as the RGB overload does, moving
+/// a gray pixel by one and leaving alpha channels and row padding untouched
+/// @param image the original pixels to take as input
+/// @param y_lsb_flips the packed plane flagging the pixels to flip, image.width * image.height bits
+/// @param image_embedded the pixels with flipped Y LSBs, of the size and the layout of image, may view the
+/// pixels of image to flip in place
+/// @return false, with image_embedded holding the original pixels, when a flagged pixel is clipping
+bool decode_y_lsb(
+    const image_view& image,
+    const bit_vector& y_lsb_flips,
+    const mutable_image_view& image_embedded);
+
+/// @brief Prices as wet the pixels whose Y can move neither up nor down by one, a channel being 0 and
+/// another one 255, so that the STC never has to flip their LSB
+/// @param rgb the RGB pixels to take as input, 3 * pixels_count of them
+/// @param pixels_count the count of pixels
+/// @param price the prices to update, pixels_count of them
+void wet_y_clipping(
+    const std::uint8_t* rgb,
+    const std::size_t pixels_count,
+    std::uint8_t* price);
+
+/// @brief Prices as wet the pixels of an image whose Y can move neither up nor down by one, gray pixels
+/// never being clipping
+/// @param image the pixels to take as input
+/// @param price the prices to update, image.width * image.height of them
+void wet_y_clipping(
+    const image_view& image,
+    std::uint8_t* price);
+
+/// @brief Finds the first pixels of an image in raster order that are not clipping, the ones wet_y_clipping
+/// leaves dry. Moving the Y of a pixel by one moves its channels alike, which keeps it clipping or not, so
+/// that the pixels found in a stego image are the ones found in its cover image.
+/// @param image the pixels to take as input, only the rows up to the last pixel found are read
+/// @param count the count of pixels to find
+/// @param indices the raster indices of the pixels found, row * width + column, count of them
+/// @return the count of pixels found, count unless the image has fewer pixels that are not clipping
+std::size_t find_unclipped_pixels(
+    const image_view& image,
+    const std::size_t count,
+    std::size_t* indices);
+
 }
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <binghamton/core/bits.hpp>
+#include <binghamton/core/image.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/method/cost.hpp>
+#include <binghamton/method/pipeline.hpp>
+#include <binghamton/method/workspace.hpp>
+
+namespace binghamton {
+
+    /// @brief Options of the streaming band functions, the embedding and the extraction must agree on the band
+    /// height
+    struct band_options {
+
+        /// @brief Rows per band, the last band also taking the rows left by the others. Each band carries its
+        /// share of the payload behind its own header. The workspace holds about one band and its halo, whatever
+        /// the height of the image.
+        std::size_t band_height = 512;
+
+        /// @brief Cover rows read above and below a band to compute its costs, 32 covering the support of the
+        /// 16 taps wavelet filters
+        std::size_t halo_rows = 32;
+
+        /// @brief The pixel layout of the rows read and written
+        pixel_layout layout = pixel_layout::rgb;
+    };
+
+    /// @brief Reads consecutive rows of an image
+    /// @param first_row the first row to read
+    /// @param rows the pixels to fill, rows.height rows of the image width in the layout of the options
+    using band_reader = std::function<void(const std::size_t first_row, const mutable_image_view& rows)>;
+
+    /// @brief Writes consecutive rows of an image
+    /// @param first_row the first row to write
+    /// @param rows the pixels to write, rows.height rows of the image width in the layout of the options
+    using band_writer = std::function<void(const std::size_t first_row, const image_view& rows)>;
+
+    /// @brief Streams the bands of an embedding, the part of embed_bands that does not depend on the cost model.
+    /// Each band is read with its halo and its Y encoded by next_band, then priced from the costs the caller
+    /// wrote for the whole window and embedded by embed_band.
+    class band_embedder {
+    public:
+        /// @brief Creates an embedder before the first band
+        /// @param width the width of the image
+        /// @param height the height of the image
+        /// @param steg_key the key of the pixel permutations, the same for every band
+        /// @param constraint_height the constraint height of the STC
+        /// @param payload_bits the packed payload bits, that must outlive the embedder
+        /// @param bands the options of the bands
+        /// @param options the options of the pipeline, the bands share a permutation cache when none is given
+        /// @param memory the workspace holding every intermediate buffer
+        /// @param read the function reading the cover rows
+        /// @param write the function writing the stego rows
+        band_embedder(
+            const std::size_t width,
+            const std::size_t height,
+            const std::array<std::uint8_t, 32> steg_key,
+            const std::uint32_t constraint_height,
+            const bit_vector& payload_bits,
+            const band_options& bands,
+            const embed_options& options,
+            workspace& memory,
+            const band_reader& read,
+            const band_writer& write);
+        band_embedder(const band_embedder& other) = delete;
+        band_embedder& operator=(const band_embedder& other) = delete;
+
+        /// @brief Reads the next band and its halo and encodes the Y of the window, the time until embed_band
+        /// counting as the cost stage
+        /// @return false once every band was embedded
+        bool next_band();
+
+        /// @brief Gets the Y pixels of the window, width * window_rows_count() of them
+        const std::uint8_t* window_y() const;
+
+        /// @brief Gets the costs of the window to fill, width * window_rows_count() of them
+        float* window_rho() const;
+
+        /// @brief Gets the count of rows of the window
+        std::size_t window_rows_count() const;
+
+        /// @brief Gets the options the costs of the window are computed with
+        const cost_options& costs() const;
+
+        /// @brief Prices the band from the costs of its window, embeds its share of the payload and writes it
+        void embed_band();
+
+        /// @brief Tells whether the stego Y of every band embedded so far survived the roundtrip to the pixels
+        bool embedded() const;
+
+        /// @brief Gets the total price of the changed payload pixels of the bands embedded so far
+        double cost_embedded() const;
+
+    private:
+        std::size_t _width;
+        std::size_t _height;
+        std::array<std::uint8_t, 32> _steg_key;
+        std::uint32_t _constraint_height;
+        const bit_vector& _payload_bits;
+        band_options _bands;
+        embed_options _embed;
+        workspace& _memory;
+        band_reader _read;
+        band_writer _write;
+        permutation_cache _permutations;
+        cost_options _costs;
+        std::size_t _height_per_band;
+        std::size_t _bands_count;
+        std::size_t _row_bytes;
+        std::uint8_t* _window;
+        std::uint8_t* _stego;
+        std::uint8_t* _y;
+        float* _rho;
+        std::uint8_t* _price;
+        std::size_t _band_index = 0;
+        std::size_t _window_first = 0;
+        std::size_t _window_last = 0;
+        std::size_t _first_row = 0;
+        std::size_t _rows_count = 0;
+        embed_timer _timer;
+        bit_vector _band_bits;
+        bool _embedded = true;
+        double _cost_embedded = 0.0;
+    };
+
+    /// @brief Embeds packed payload bits in an image streamed in bands of rows, each band priced with its halo by a
+    /// cost model and carrying a share of the payload proportional to its pixels, permuted within the band. Each row
+    /// is read once and the stego bands are written in order.
+    /// @tparam cost_model_t the cost model, a type with a static cost function as wow_cost_model
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param steg_key the key of the pixel permutations, the same for every band
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bits the packed payload bits
+    /// @param bands the options of the bands
+    /// @param options the options of the pipeline, the bands share a permutation cache when none is given
+    /// @param memory the workspace holding every intermediate buffer
+    /// @param read the function reading the cover rows
+    /// @param write the function writing the stego rows
+    /// @param cost_embedded the total price of the changed payload pixels
+    /// @return true if the stego Y of every band survived the roundtrip to the pixels
+    template <typename cost_model_t>
+    bool embed_bands(
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const band_options& bands,
+        const embed_options& options,
+        workspace& memory,
+        const band_reader& read,
+        const band_writer& write,
+        double& cost_embedded)
+    {
+        band_embedder embedder(width, height, steg_key, constraint_height, payload_bits, bands, options, memory, read, write);
+        while (embedder.next_band()) {
+            cost_model_t::cost(embedder.window_y(), width, embedder.window_rows_count(), embedder.costs(), embedder.window_rho());
+            embedder.embed_band();
+        }
+        cost_embedded = embedder.cost_embedded();
+        return embedder.embedded();
+    }
+
+    /// @brief Extracts packed payload bits embedded by embed_bands, one band of rows at a time. An image without
+    /// payload header is rejected from the first band.
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param steg_key the key of the pixel permutations
+    /// @param constraint_height the constraint height of the STC
+    /// @param max_payload_bit_count the upper bound of the payload bit count
+    /// @param bands the options of the bands, with the band height of the embedding, the halo is not used
+    /// @param options the options of the extraction, the bands share a permutation cache when none is given
+    /// @param memory the workspace holding every intermediate buffer
+    /// @param read the function reading the stego rows
+    /// @param payload_bits_out the packed payload bits
+    void extract_bands(
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t max_payload_bit_count,
+        const band_options& bands,
+        const extract_options& options,
+        workspace& memory,
+        const band_reader& read,
+        bit_vector& payload_bits_out);
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <binghamton/core/bits.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/core/thread_pool.hpp>
+#include <binghamton/method/pipeline.hpp>
+#include <binghamton/method/workspace.hpp>
+
+namespace binghamton {
+
+    /// @brief One cover image of an embedding batch, the referenced buffers must outlive the batch
+    struct embed_job {
+        const std::vector<std::uint8_t>* rgb = nullptr;
+        std::size_t width = 0;
+        std::size_t height = 0;
+        std::array<std::uint8_t, 32> steg_key {};
+        const bit_vector* payload_bits = nullptr;
+    };
+
+    /// @brief Outcome of one embed_job
+    struct embed_result {
+        std::vector<std::uint8_t> rgb_embedded;
+        double cost_embedded = 0.0;
+
+        /// @brief The value returned by the embedding, false when the stego Y did not survive the RGB roundtrip
+        bool embedded = false;
+
+        /// @brief The message of the exception thrown by the embedding, empty when it returned
+        std::string error;
+    };
+
+    /// @brief One stego image of an extraction batch, the referenced buffer must outlive the batch
+    struct extract_job {
+        const std::vector<std::uint8_t>* rgb_stego = nullptr;
+        std::size_t width = 0;
+        std::size_t height = 0;
+        std::array<std::uint8_t, 32> steg_key {};
+        std::size_t max_payload_bit_count = 0;
+    };
+
+    /// @brief Outcome of one extract_job
+    struct extract_result {
+        bit_vector payload_bits;
+
+        /// @brief The message of the exception thrown by the extraction, empty when it returned
+        std::string error;
+    };
+
+    /// @brief Options of the batch functions
+    struct batch_options {
+
+        /// @brief Pool running one image per thread, nullptr runs the batch on the calling thread. Each cost
+        /// map is computed on the thread of its image.
+        thread_pool* pool = nullptr;
+
+        /// @brief Cache of the key-derived permutations kept across batches, nullptr shares them within the
+        /// batch only
+        permutation_cache* permutations = nullptr;
+
+        /// @brief Upper bound in bytes of the permutations shared within the batch when permutations is
+        /// nullptr, 0 for no bound. A table takes 8 bytes per pixel, the least recently used ones are dropped.
+        std::size_t permutations_byte_limit = std::size_t(256) << 20;
+
+        /// @brief Workspaces lent to the images and kept across batches, nullptr reuses them within the batch
+        /// only. A running image holds one workspace, so the pool grows to one workspace per thread.
+        workspace_pool* workspaces = nullptr;
+    };
+
+    /// @brief Runs every job of a batch and records the exception each one throws
+    /// @param count the count of jobs
+    /// @param options the options of the batch
+    /// @param job the function running one job
+    /// @param errors the function recording the message of the exception thrown by a job
+    void run_batch(
+        const std::size_t count,
+        const batch_options& options,
+        const std::function<void(std::size_t)>& job,
+        const std::function<void(std::size_t, const std::string&)>& errors);
+
+    /// @brief Embeds payloads in many images priced by a cost model, one bad image does not abort the batch
+    /// @tparam cost_model_t the cost model, as wow_cost_model
+    /// @param jobs the images to embed
+    /// @param constraint_height the constraint height of the STC
+    /// @param options the options of the batch
+    /// @param results the outcome of each job, in the order of the jobs
+    template <typename cost_model_t>
+    void embed_batch(
+        const std::vector<embed_job>& jobs,
+        const std::uint32_t constraint_height,
+        const batch_options& options,
+        std::vector<embed_result>& results)
+    {
+        results.clear();
+        results.resize(jobs.size());
+
+        permutation_cache batch_permutations(options.permutations_byte_limit);
+        embed_options embed;
+        embed.permutations = options.permutations != nullptr ? options.permutations : &batch_permutations;
+        workspace_pool batch_workspaces;
+        workspace_pool& workspaces = options.workspaces != nullptr ? *options.workspaces : batch_workspaces;
+
+        run_batch(
+            jobs.size(), options,
+            [&](const std::size_t index) {
+                const embed_job& job = jobs[index];
+                embed_result& result = results[index];
+                if (job.rgb == nullptr || job.payload_bits == nullptr) {
+                    throw std::runtime_error("embed_batch: rgb and payload_bits cannot be null");
+                }
+                if (job.rgb->size() != 3 * job.width * job.height) {
+                    throw std::runtime_error("embed_batch: rgb.size() must be equal to 3 * width * height");
+                }
+                result.rgb_embedded.resize(job.rgb->size());
+                workspace_pool::lease memory = workspaces.acquire();
+                result.embedded = embed_luminance<cost_model_t>(make_image_view(*job.rgb, job.width, job.height), job.steg_key, constraint_height, *job.payload_bits, embed, *memory, make_image_view(result.rgb_embedded, job.width, job.height), result.cost_embedded);
+            },
+            [&](const std::size_t index, const std::string& error) {
+                results[index].error = error;
+            });
+    }
+
+    /// @brief Extracts payloads from many images, one bad image does not abort the batch
+    /// @param jobs the images to extract from
+    /// @param constraint_height the constraint height of the STC
+    /// @param options the options of the batch
+    /// @param results the outcome of each job, in the order of the jobs
+    void extract_batch(
+        const std::vector<extract_job>& jobs,
+        const std::uint32_t constraint_height,
+        const batch_options& options,
+        std::vector<extract_result>& results);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace binghamton {
+
+/// @brief Algorithm used to correlate a plane with a 1-D kernel
+enum struct convolution_method {
+
+    /// @brief Picks direct for short kernels and fft for long ones
+    automatic,
+
+    /// @brief Multiply-accumulates every tap, best for short kernels
+    direct,
+
+    /// @brief Multiplies spectra two lines at a time, best for long kernels
+    fft
+};
+
+/// @brief Computes the source index of a symmetric padding ('symmetric' in matlab), which mirrors the
+/// plane with its edge repeated and keeps mirroring when the padding exceeds the plane
+/// @param index the index in the padded plane, relative to the first sample of the plane
+/// @param count the count of samples of the plane
+/// @return the index of the sample read by the padding
+inline std::size_t symmetric_index(std::ptrdiff_t index, const std::size_t count)
+{
+    const std::ptrdiff_t period = 2 * static_cast<std::ptrdiff_t>(count);
+    index %= period;
+    if (index < 0) {
+        index += period;
+    }
+    return static_cast<std::size_t>(index < static_cast<std::ptrdiff_t>(count) ? index : period - 1 - index);
+}
+
+/// @brief Correlates every row of a plane with a 1-D kernel, output(x, y) = sum of taps[t] * input(x + t, y)
+/// @param input the first input sample, each row needs output_width + taps.size() - 1 samples
+/// @param input_stride the count of floats between two input rows
+/// @param output_width the count of samples computed per row
+/// @param height the count of rows
+/// @param taps the kernel, applied without flipping
+/// @param output the first output sample
+/// @param output_stride the count of floats between two output rows
+/// @param method the algorithm to use
+void correlate_rows(
+    const float* input,
+    const std::size_t input_stride,
+    const std::size_t output_width,
+    const std::size_t height,
+    const std::vector<float>& taps,
+    float* output,
+    const std::size_t output_stride,
+    const convolution_method method = convolution_method::automatic);
+
+/// @brief Correlates every column of a plane with a 1-D kernel, output(x, y) = sum of taps[t] * input(x, y + t)
+/// @param input the first input sample, each column needs output_height + taps.size() - 1 samples
+/// @param input_stride the count of floats between two input rows
+/// @param width the count of columns
+/// @param output_height the count of samples computed per column
+/// @param taps the kernel, applied without flipping
+/// @param output the first output sample
+/// @param output_stride the count of floats between two output rows
+/// @param method the algorithm to use
+void correlate_columns(
+    const float* input,
+    const std::size_t input_stride,
+    const std::size_t width,
+    const std::size_t output_height,
+    const std::vector<float>& taps,
+    float* output,
+    const std::size_t output_stride,
+    const convolution_method method = convolution_method::automatic);
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <binghamton/core/scratch.hpp>
+#include <binghamton/core/stc.hpp>
+#include <binghamton/core/thread_pool.hpp>
+
+namespace binghamton {
+
+    /// @brief Costs at or above this value (or undefined) make a pixel wet
+    constexpr float wet_cost = 1e10f;
+
+    /// @brief Options of the cost functions
+    struct cost_options {
+
+        /// @brief Pool computing the row tiles of the cost map in parallel, nullptr runs them on the calling thread.
+        /// Tiles have a fixed height and overlap by the halo of the filters, so that the costs are bit-identical
+        /// whatever the pool size.
+        thread_pool* pool = nullptr;
+
+        /// @brief Scratch memory of the tiles kept between calls, nullptr allocates it for the call. Costing
+        /// images no larger than the previous ones with the same options then does not allocate.
+        scratch_pool* scratch = nullptr;
+    };
+
+    /// @brief Rows per tile of a cost map. Tiles recompute the halo of the filters on both sides, 128 rows
+    /// keep that overhead around an eighth of the 16 taps wavelet filters.
+    constexpr std::size_t cost_tile_height = 128;
+
+    /// @brief Runs a function over the row tiles of a cost map, in parallel when the options have a pool
+    /// @tparam function_t a callable as void(std::size_t first_row, std::size_t rows_count, scratch& tile_scratch)
+    /// @param height the count of rows of the cost map
+    /// @param options the options of the cost function
+    /// @param function the function computing the rows [first_row, first_row + rows_count) with a scratch
+    /// no other running tile uses
+    template <typename function_t>
+    void for_each_cost_tile(
+        const std::size_t height,
+        const cost_options& options,
+        const function_t& function)
+    {
+        scratch_pool local_scratch;
+        scratch_pool& tile_scratch = options.scratch != nullptr ? *options.scratch : local_scratch;
+        const std::size_t tiles_count = (height + cost_tile_height - 1) / cost_tile_height;
+        const auto tile = [&](const std::size_t index) {
+            const std::size_t first_row = index * cost_tile_height;
+            const scratch_pool::lease memory = tile_scratch.acquire();
+            function(first_row, std::min(cost_tile_height, height - first_row), *memory);
+        };
+        if (options.pool != nullptr) {
+            // Wrapping a reference keeps std::function from allocating a copy of the lambda
+            options.pool->parallel_for(tiles_count, std::cref(tile));
+        } else {
+            for (std::size_t index = 0; index < tiles_count; ++index) {
+                tile(index);
+            }
+        }
+    }
+
+    /// @brief Quantizes costs to prices for the STC, normalized by the cheapest pixel
+    /// @param rho the costs to take as input, wet_cost for wet pixels
+    /// @param price the prices to take as output, 8 for the cheapest pixel up to 254, wet_price for wet pixels
+    void quantize_costs(
+        const std::vector<float>& rho,
+        std::vector<std::uint8_t>& price);
+
+    /// @brief Quantizes costs to prices for the STC, normalized by the cheapest pixel
+    /// @param rho the costs to take as input, wet_cost for wet pixels
+    /// @param options the options running the quantization
+    /// @param price the prices to take as output, 8 for the cheapest pixel up to 254, wet_price for wet pixels
+    void quantize_costs(
+        const std::vector<float>& rho,
+        const cost_options& options,
+        std::vector<std::uint8_t>& price);
+
+    /// @brief Quantizes costs to prices for the STC, normalized by the cheapest pixel
+    /// @param rho the costs to take as input, wet_cost for wet pixels
+    /// @param count the count of costs
+    /// @param options the options running the quantization
+    /// @param price the prices to take as output, count of them, 8 for the cheapest pixel up to 254, wet_price for wet pixels
+    void quantize_costs(
+        const float* rho,
+        const std::size_t count,
+        const cost_options& options,
+        std::uint8_t* price);
+}
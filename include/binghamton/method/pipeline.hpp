@@ -0,0 +1,500 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <binghamton/core/bits.hpp>
+#include <binghamton/core/image.hpp>
+#include <binghamton/core/lsb.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/core/thread_pool.hpp>
+#include <binghamton/core/ycbcr.hpp>
+#include <binghamton/method/cost.hpp>
+#include <binghamton/method/workspace.hpp>
+
+namespace binghamton {
+
+    /// @brief Count of pixels whose Y LSBs hold the payload header, the first ones that are not clipping, before
+    /// the pixels of the STC. The header holds a magic number, its version, the permutation version, the payload bit
+    /// count and the CRC-32 of the payload, masked by a stream derived from the key so that it cannot be told apart
+    /// without the key.
+    constexpr std::size_t payload_header_bits = 96;
+
+    /// @brief Gets the count of first pixels of an image spanned by the payload header, its payload_header_bits pixels
+    /// that are not clipping and the clipping ones between them. The payload pixels are the ones after it, the span
+    /// of a stego image being the span of its cover image.
+    /// @param image the pixels of the image
+    std::size_t payload_header_span(const image_view& image);
+
+    /// @brief Stages of an embedding timed by embed_stats
+    enum struct embed_stage : std::size_t {
+
+        /// @brief The Y of the pixels and its LSB plane
+        encode_y,
+
+        /// @brief The cost map, its prices and the wet clipping pixels
+        cost,
+
+        /// @brief The permutation and the gather of the symbols and prices in its order
+        permutation,
+
+        /// @brief The STC
+        stc,
+
+        /// @brief The changed pixels flagged and written to the stego pixels
+        reinjection
+    };
+
+    /// @brief Count of the values of embed_stage
+    constexpr std::size_t embed_stages_count = 5;
+
+    /// @brief Measurements of embeddings, added to by each embedding so that the bands of an image or the frames
+    /// of a sequence sum up. Assign embed_stats {} to start over.
+    struct embed_stats {
+
+        /// @brief The wall time in seconds of each stage, indexed by embed_stage
+        std::array<double, embed_stages_count> stage_seconds {};
+
+        /// @brief The count of bytes the workspace grew by
+        std::size_t allocated_bytes = 0;
+
+        /// @brief The largest count of bytes the workspace held
+        std::size_t peak_workspace_bytes = 0;
+
+        /// @brief The count of payload bits embedded
+        std::size_t payload_bit_count = 0;
+
+        /// @brief The count of pixels whose Y LSB changed, the header pixels included
+        std::size_t changed_pixels_count = 0;
+
+        /// @brief The total price of the changed payload pixels
+        double distortion = 0.0;
+
+        /// @brief Gets the payload bits embedded per changed pixel, 0 without changes
+        double efficiency() const
+        {
+            return changed_pixels_count != 0 ? static_cast<double>(payload_bit_count) / static_cast<double>(changed_pixels_count) : 0.0;
+        }
+
+        /// @brief Adds the growth of a workspace to the allocated bytes and its capacity to the peak
+        /// @param memory the workspace
+        /// @param capacity_before the capacity of the workspace before it grew
+        void record_workspace(const workspace& memory, const std::size_t capacity_before);
+    };
+
+    /// @brief Clock adding the wall time of the stages of an embedding to its stats, read only when there are stats
+    class embed_timer {
+    public:
+        /// @brief Starts the first stage
+        /// @param stats the stats to add to, nullptr to measure nothing
+        explicit embed_timer(embed_stats* stats)
+            : _stats(stats)
+        {
+            if (_stats != nullptr) {
+                _start = std::chrono::steady_clock::now();
+            }
+        }
+
+        /// @brief Adds the time since the previous lap to a stage and starts the next one
+        /// @param stage the stage that ended
+        void lap(const embed_stage stage)
+        {
+            if (_stats != nullptr) {
+                const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                _stats->stage_seconds[static_cast<std::size_t>(stage)] += std::chrono::duration<double>(now - _start).count();
+                _start = now;
+            }
+        }
+
+    private:
+        embed_stats* _stats;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+    /// @brief Options of the luminance pipeline
+    struct embed_options {
+
+        /// @brief Pool computing the cost map in parallel, nullptr runs it on the calling thread. The stego
+        /// image does not depend on the pool size.
+        thread_pool* pool = nullptr;
+
+        /// @brief Cache sharing the key-derived permutations between images of the same size, nullptr
+        /// computes the permutation of every image. Unused by the feistel permutation, which has no table.
+        permutation_cache* permutations = nullptr;
+
+        /// @brief The permutation of the payload pixels, the embedding and the extraction must agree
+        permutation_version permutation = permutation_version::shuffle;
+
+        /// @brief Measurements the embedding adds to, nullptr measures nothing and does not read the clock
+        embed_stats* stats = nullptr;
+    };
+
+    /// @brief Options of the luminance extraction
+    struct extract_options {
+
+        /// @brief Cache sharing the key-derived permutations between images of the same size, nullptr
+        /// computes the permutation of every image. Unused by the feistel permutation, which has no table.
+        permutation_cache* permutations = nullptr;
+
+        /// @brief The permutation of the payload pixels, the embedding and the extraction must agree
+        permutation_version permutation = permutation_version::shuffle;
+    };
+
+    /// @brief Embeds packed payload bits in the Y LSBs of an RGB image, spread by the key and priced beforehand
+    /// @param rgb the RGB pixels of the cover image
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bits the packed payload bits
+    /// @param y the Y pixels of the cover image, encode_y of rgb
+    /// @param price the price of changing each Y pixel
+    /// @param options the options of the pipeline, the pool is not used
+    /// @param rgb_embedded the RGB pixels of the stego image, may be rgb to embed in place
+    /// @param cost_embedded the total price of the changed payload pixels
+    /// @return true if the stego Y survived the RGB roundtrip
+    bool embed_priced_luminance(
+        const std::vector<std::uint8_t>& rgb,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const std::vector<std::uint8_t>& y,
+        const std::vector<std::uint8_t>& price,
+        const embed_options& options,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded);
+
+    /// @brief Embeds packed payload bits in the Y LSBs of the pixels of an image, spread by the key and priced beforehand
+    /// @param image the pixels of the cover image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bits the packed payload bits
+    /// @param y the Y pixels of the cover image, width * height of them
+    /// @param price the price of changing each Y pixel, wet for the pixels wet_y_clipping wets
+    /// @param options the options of the pipeline, the pool is not used
+    /// @param memory the workspace holding every intermediate buffer
+    /// @param image_embedded the pixels of the stego image, of the size and the layout of image, may view the
+    /// pixels of image to embed in place
+    /// @param cost_embedded the total price of the changed payload pixels
+    /// @return true if the stego Y survived the roundtrip to the pixels
+    bool embed_priced_luminance(
+        const image_view& image,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const std::uint8_t* y,
+        const std::uint8_t* price,
+        const embed_options& options,
+        workspace& memory,
+        const mutable_image_view& image_embedded,
+        double& cost_embedded);
+
+    /// @brief Y pixels of a cover image and the planes of their costs and prices, held by a workspace
+    struct luminance_planes {
+
+        /// @brief The Y pixels, width * height of them
+        const std::uint8_t* y = nullptr;
+
+        /// @brief The costs of changing each Y pixel, width * height of them
+        float* rho = nullptr;
+
+        /// @brief The prices of changing each Y pixel, width * height of them
+        std::uint8_t* price = nullptr;
+    };
+
+    /// @brief Gets the Y pixels of an image and room for their costs and prices, the part of embed_luminance that
+    /// does not depend on the cost model. A packed gray image is its own Y plane.
+    /// @param image the pixels of the cover image
+    /// @param memory the workspace holding the planes
+    /// @return the planes, valid until the workspace serves another image
+    luminance_planes encode_luminance(
+        const image_view& image,
+        workspace& memory);
+
+    /// @brief Embeds packed payload bits in the Y LSBs of the pixels of an image, spread by the key and priced by
+    /// a cost model. A packed gray image is priced without copying its pixels.
+    /// @tparam cost_model_t the cost model, a type with a static cost function as wow_cost_model
+    /// @param image the pixels of the cover image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bits the packed payload bits
+    /// @param options the options of the pipeline
+    /// @param memory the workspace holding every intermediate buffer
+    /// @param image_embedded the pixels of the stego image, of the size and the layout of image, may view the
+    /// pixels of image to embed in place
+    /// @param cost_embedded the total price of the changed payload pixels
+    /// @return true if the stego Y survived the roundtrip to the pixels
+    template <typename cost_model_t>
+    bool embed_luminance(
+        const image_view& image,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const embed_options& options,
+        workspace& memory,
+        const mutable_image_view& image_embedded,
+        double& cost_embedded)
+    {
+        if (!is_valid(image)) {
+            throw std::runtime_error("embed_luminance: image must have pixels and a stride of at least width * channels_count(layout)");
+        }
+
+        const std::size_t capacity = options.stats != nullptr ? memory.capacity() : 0;
+        embed_timer timer(options.stats);
+        const luminance_planes planes = encode_luminance(image, memory);
+        timer.lap(embed_stage::encode_y);
+
+        cost_options costs;
+        costs.pool = options.pool;
+        costs.scratch = &memory.tasks;
+        cost_model_t::cost(planes.y, image.width, image.height, costs, planes.rho);
+        quantize_costs(planes.rho, image.width * image.height, costs, planes.price);
+        wet_y_clipping(image, planes.price);
+        timer.lap(embed_stage::cost);
+        if (options.stats != nullptr) {
+            options.stats->record_workspace(memory, capacity);
+        }
+
+        return embed_priced_luminance(image, steg_key, constraint_height, payload_bits, planes.y, planes.price, options, memory, image_embedded, cost_embedded);
+    }
+
+    /// @brief Embeds packed payload bits in the Y LSBs of an RGB image, spread by the key and priced by a cost model
+    /// @tparam cost_model_t the cost model, a type with a static cost function as wow_cost_model
+    /// @param rgb the RGB pixels of the cover image
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bits the packed payload bits
+    /// @param options the options of the pipeline
+    /// @param memory the workspace holding every intermediate buffer
+    /// @param rgb_embedded the RGB pixels of the stego image, may be rgb to embed in place
+    /// @param cost_embedded the total price of the changed payload pixels
+    /// @return true if the stego Y survived the RGB roundtrip
+    template <typename cost_model_t>
+    bool embed_luminance(
+        const std::vector<std::uint8_t>& rgb,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const embed_options& options,
+        workspace& memory,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded)
+    {
+        if (rgb.size() != 3 * width * height) {
+            throw std::runtime_error("embed_luminance: rgb.size() must be equal to 3 * width * height");
+        }
+
+        rgb_embedded.resize(rgb.size());
+        return embed_luminance<cost_model_t>(make_image_view(rgb, width, height), steg_key, constraint_height, payload_bits, options, memory, make_image_view(rgb_embedded, width, height), cost_embedded);
+    }
+
+    /// @brief Embeds packed payload bits in the Y LSBs of an RGB image, spread by the key and priced by a cost model
+    /// @tparam cost_model_t the cost model, a type with a static cost function as wow_cost_model
+    /// @param rgb the RGB pixels of the cover image
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bits the packed payload bits
+    /// @param options the options of the pipeline
+    /// @param rgb_embedded the RGB pixels of the stego image, may be rgb to embed in place
+    /// @param cost_embedded the total price of the changed payload pixels
+    /// @return true if the stego Y survived the RGB roundtrip
+    template <typename cost_model_t>
+    bool embed_luminance(
+        const std::vector<std::uint8_t>& rgb,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const embed_options& options,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded)
+    {
+        workspace memory;
+        return embed_luminance<cost_model_t>(rgb, width, height, steg_key, constraint_height, payload_bits, options, memory, rgb_embedded, cost_embedded);
+    }
+
+    /// @brief Cover image with everything the embedding computes from the cover alone, so that embedding many
+    /// payloads or keys in it only permutes the pixels and runs the STC
+    struct prepared_cover {
+
+        /// @brief The RGB pixels of the cover image
+        std::vector<std::uint8_t> rgb;
+
+        /// @brief The width of the image
+        std::size_t width = 0;
+
+        /// @brief The height of the image
+        std::size_t height = 0;
+
+        /// @brief The Y pixels of the cover image
+        std::vector<std::uint8_t> y;
+
+        /// @brief The packed LSB plane of the Y pixels
+        bit_vector symbols;
+
+        /// @brief The price of changing each Y pixel
+        std::vector<std::uint8_t> price;
+    };
+
+    /// @brief Computes the Y pixels, their LSB plane and their prices once for many embeddings
+    /// @tparam cost_model_t the cost model, a type with a static cost function as wow_cost_model
+    /// @param rgb the RGB pixels of the cover image
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param options the options running the cost model
+    /// @param cover the prepared cover
+    template <typename cost_model_t>
+    void prepare_cover(
+        const std::vector<std::uint8_t>& rgb,
+        const std::size_t width,
+        const std::size_t height,
+        const cost_options& options,
+        prepared_cover& cover)
+    {
+        if (rgb.size() != 3 * width * height) {
+            throw std::runtime_error("prepare_cover: rgb.size() must be equal to 3 * width * height");
+        }
+
+        const std::size_t pixels_count = width * height;
+        cover.rgb = rgb;
+        cover.width = width;
+        cover.height = height;
+        encode_y(rgb, cover.y);
+        encode_lsb(cover.y, cover.symbols);
+
+        std::vector<float> rho(pixels_count);
+        cover.price.resize(pixels_count);
+        cost_model_t::cost(cover.y.data(), width, height, options, rho.data());
+        quantize_costs(rho.data(), pixels_count, options, cover.price.data());
+        wet_y_clipping(rgb.data(), pixels_count, cover.price.data());
+    }
+
+    /// @brief Embeds packed payload bits in the Y LSBs of a prepared cover, the stego image being the same as
+    /// embed_luminance with the cost model of the preparation
+    /// @param cover the prepared cover
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bits the packed payload bits
+    /// @param options the options of the pipeline, the pool is not used
+    /// @param rgb_embedded the RGB pixels of the stego image
+    /// @param cost_embedded the total price of the changed payload pixels
+    /// @return true if the stego Y survived the RGB roundtrip
+    bool embed_prepared(
+        const prepared_cover& cover,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const embed_options& options,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded);
+
+    /// @brief Embeds packed payload bits in the Y LSBs of a prepared cover, the stego image being the same as
+    /// embed_luminance with the cost model of the preparation
+    /// @param cover the prepared cover
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bits the packed payload bits
+    /// @param options the options of the pipeline, the pool is not used
+    /// @param memory the workspace holding every intermediate buffer
+    /// @param rgb_embedded the RGB pixels of the stego image
+    /// @param cost_embedded the total price of the changed payload pixels
+    /// @return true if the stego Y survived the RGB roundtrip
+    bool embed_prepared(
+        const prepared_cover& cover,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const embed_options& options,
+        workspace& memory,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded);
+
+    /// @brief Extracts packed payload bits embedded by embed_luminance, whatever the cost function used
+    /// @param rgb_stego the RGB pixels of the stego image
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bit_count the upper bound of the payload bit count
+    /// @param payload_bits_out the packed payload bits
+    void extract_luminance(
+        const std::vector<std::uint8_t>& rgb_stego,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t payload_bit_count,
+        bit_vector& payload_bits_out);
+
+    /// @brief Extracts packed payload bits embedded by embed_luminance, whatever the cost function used
+    /// @param rgb_stego the RGB pixels of the stego image
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bit_count the upper bound of the payload bit count
+    /// @param options the options of the extraction
+    /// @param payload_bits_out the packed payload bits
+    void extract_luminance(
+        const std::vector<std::uint8_t>& rgb_stego,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t payload_bit_count,
+        const extract_options& options,
+        bit_vector& payload_bits_out);
+
+    /// @brief Extracts packed payload bits embedded by embed_luminance, whatever the cost function used
+    /// @param rgb_stego the RGB pixels of the stego image
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bit_count the upper bound of the payload bit count
+    /// @param options the options of the extraction
+    /// @param memory the workspace holding every intermediate buffer
+    /// @param payload_bits_out the packed payload bits
+    void extract_luminance(
+        const std::vector<std::uint8_t>& rgb_stego,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t payload_bit_count,
+        const extract_options& options,
+        workspace& memory,
+        bit_vector& payload_bits_out);
+
+    /// @brief Extracts packed payload bits embedded by embed_luminance from the pixels of an image, whatever the
+    /// cost function used. An image without payload header is rejected from the pixels of the header alone, a
+    /// payload whose checksum does not match is rejected once decoded.
+    /// @param image_stego the pixels of the stego image
+    /// @param steg_key the key of the pixel permutation
+    /// @param constraint_height the constraint height of the STC
+    /// @param payload_bit_count the upper bound of the payload bit count
+    /// @param options the options of the extraction
+    /// @param memory the workspace holding every intermediate buffer
+    /// @param payload_bits_out the packed payload bits
+    void extract_luminance(
+        const image_view& image_stego,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t payload_bit_count,
+        const extract_options& options,
+        workspace& memory,
+        bit_vector& payload_bits_out);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <binghamton/method/pipeline.hpp>
+
+namespace binghamton {
+
+    /// @brief Optimal binary embedding of priced pixels, each pixel changing with the Gibbs probability
+    /// exp(-lambda * price) / (1 + exp(-lambda * price)) of its price and wet pixels never changing. It bounds
+    /// what the STC reaches for the same payload.
+    struct gibbs_embedding {
+
+        /// @brief The Lagrange multiplier of the distortion
+        double lambda = 0.0;
+
+        /// @brief The entropy of the changes in bits, the payload an optimal code embeds
+        double payload_bit_count = 0.0;
+
+        /// @brief The expected total price of the changes
+        double distortion = 0.0;
+
+        /// @brief The expected count of changed pixels
+        double changed_pixels_count = 0.0;
+
+        /// @brief The change probability of each price
+        std::array<double, 256> probability {};
+    };
+
+    /// @brief Solves the optimal embedding of a payload, by a binary search on lambda over the histogram of the
+    /// prices so that each step costs 256 evaluations whatever the count of pixels
+    /// @param price the prices of the pixels, wet_price for wet pixels
+    /// @param count the count of pixels
+    /// @param payload_bit_count the payload bit count, at most the count of dry pixels
+    /// @param embedding the optimal embedding
+    void solve_gibbs_payload(
+        const std::uint8_t* price,
+        const std::size_t count,
+        const double payload_bit_count,
+        gibbs_embedding& embedding);
+
+    /// @brief Solves the optimal embedding of a distortion budget, by a binary search on lambda over the histogram
+    /// of the prices so that each step costs 256 evaluations whatever the count of pixels
+    /// @param price the prices of the pixels, wet_price for wet pixels
+    /// @param count the count of pixels
+    /// @param distortion the expected total price of the changes
+    /// @param embedding the optimal embedding, with every dry pixel changing with probability 1/2 when the budget
+    /// exceeds the distortion of the largest payload
+    void solve_gibbs_distortion(
+        const std::uint8_t* price,
+        const std::size_t count,
+        const double distortion,
+        gibbs_embedding& embedding);
+
+    /// @brief Estimates the largest payload a prepared cover carries within a distortion budget, from its prices
+    /// without running the STC
+    /// @param cover the prepared cover
+    /// @param distortion the expected total price of the changes
+    /// @return the payload bit count of the optimal embedding, which the STC approaches from below
+    std::size_t estimate_capacity(
+        const prepared_cover& cover,
+        const double distortion);
+
+    /// @brief Simulates the optimal embedding of a payload in a prepared cover, each payload pixel changing at
+    /// random with its Gibbs probability instead of running the STC. The pixels the payload header spans stay unchanged.
+    /// @param cover the prepared cover
+    /// @param payload_bit_count the payload bit count
+    /// @param seed the seed of the random changes
+    /// @param rgb_embedded the RGB pixels of the simulated stego image
+    /// @param embedding the optimal embedding simulated
+    /// @return true if the stego Y survived the RGB roundtrip
+    bool simulate_embedding(
+        const prepared_cover& cover,
+        const std::size_t payload_bit_count,
+        const std::uint64_t seed,
+        std::vector<std::uint8_t>& rgb_embedded,
+        gibbs_embedding& embedding);
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <binghamton/core/bits.hpp>
+#include <binghamton/method/cost.hpp>
+#include <binghamton/method/pipeline.hpp>
+#include <binghamton/method/wavelet.hpp>
+
+namespace binghamton {
+
+    /// @brief Computes the S-UNIWARD cost of changing each Y pixel, from the Daubechies 8 directional filter bank
+    /// @param y the Y pixels to take as input
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param rho the costs to take as output, 1e10 for wet pixels
+    void cost_suniward(
+        const std::vector<std::uint8_t>& y,
+        const std::size_t width,
+        const std::size_t height,
+        std::vector<float>& rho);
+
+    /// @brief Computes the S-UNIWARD cost of changing each Y pixel, from the Daubechies 8 directional filter bank
+    /// @param y the Y pixels to take as input
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param options the options running the computation
+    /// @param rho the costs to take as output, 1e10 for wet pixels
+    void cost_suniward(
+        const std::vector<std::uint8_t>& y,
+        const std::size_t width,
+        const std::size_t height,
+        const cost_options& options,
+        std::vector<float>& rho);
+
+    /// @brief Computes the S-UNIWARD cost of changing each Y pixel quantized to prices for the STC
+    /// @param y the Y pixels to take as input
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param price the prices to take as output, 8 for the cheapest pixel up to 254, wet_price for wet pixels
+    void price_suniward(
+        const std::vector<std::uint8_t>& y,
+        const std::size_t width,
+        const std::size_t height,
+        std::vector<std::uint8_t>& price);
+
+    /// @brief Computes the S-UNIWARD cost of changing each Y pixel quantized to prices for the STC
+    /// @param y the Y pixels to take as input
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param options the options running the computation
+    /// @param price the prices to take as output, 8 for the cheapest pixel up to 254, wet_price for wet pixels
+    void price_suniward(
+        const std::vector<std::uint8_t>& y,
+        const std::size_t width,
+        const std::size_t height,
+        const cost_options& options,
+        std::vector<std::uint8_t>& price);
+
+    /// @brief Cost model of embed_luminance costing Y pixels with cost_suniward
+    struct suniward_cost_model {
+        static void cost(
+            const std::uint8_t* y,
+            const std::size_t width,
+            const std::size_t height,
+            const cost_options& options,
+            float* rho)
+        {
+            cost_wavelet(y, width, height, wavelet_cost::suniward, options, rho);
+        }
+    };
+
+    bool embed_suniward(
+        const std::vector<std::uint8_t>& rgb,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::vector<std::uint8_t>& payload_bits,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded);
+
+    bool embed_suniward(
+        const std::vector<std::uint8_t>& rgb,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded);
+
+    bool embed_suniward(
+        const std::vector<std::uint8_t>& rgb,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const embed_options& options,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded);
+
+    void extract_suniward(
+        const std::vector<std::uint8_t>& rgb_stego,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t payload_bit_count,
+        std::vector<std::uint8_t>& payload_bits_out);
+
+    void extract_suniward(
+        const std::vector<std::uint8_t>& rgb_stego,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t payload_bit_count,
+        bit_vector& payload_bits_out);
+
+    bool embed_suniward(
+        const std::vector<std::uint8_t>& rgb,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const embed_options& options,
+        workspace& memory,
+        std::vector<std::uint8_t>& rgb_embedded,
+        double& cost_embedded);
+
+    void extract_suniward(
+        const std::vector<std::uint8_t>& rgb_stego,
+        const std::size_t width,
+        const std::size_t height,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t payload_bit_count,
+        const extract_options& options,
+        workspace& memory,
+        bit_vector& payload_bits_out);
+
+    bool embed_suniward(
+        const image_view& image,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const embed_options& options,
+        workspace& memory,
+        const mutable_image_view& image_embedded,
+        double& cost_embedded);
+
+    void extract_suniward(
+        const image_view& image_stego,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const std::size_t payload_bit_count,
+        const extract_options& options,
+        workspace& memory,
+        bit_vector& payload_bits_out);
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <binghamton/core/bits.hpp>
+#include <binghamton/core/image.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/method/cost.hpp>
+#include <binghamton/method/pipeline.hpp>
+#include <binghamton/method/workspace.hpp>
+
+namespace binghamton {
+
+    /// @brief Non-owning planar YUV 4:2:0 frame, a luma plane and two chroma planes of half its width and
+    /// height. The buffers must outlive the frame.
+    struct yuv420_frame {
+        std::uint8_t* y = nullptr;
+        std::uint8_t* u = nullptr;
+        std::uint8_t* v = nullptr;
+        std::size_t width = 0;
+        std::size_t height = 0;
+
+        /// @brief The count of bytes between the first pixels of two luma rows, at least width
+        std::size_t y_stride = 0;
+
+        /// @brief The count of bytes between the first pixels of two chroma rows, at least (width + 1) / 2
+        std::size_t uv_stride = 0;
+    };
+
+    /// @brief Views the luma plane of a frame as a gray image
+    /// @param frame the frame
+    mutable_image_view luma_view(const yuv420_frame& frame);
+
+    /// @brief Embeds one payload across the luma planes of consecutive frames, in place. Each frame carries the
+    /// next frame_bit_count payload bits behind its own length prefix, the last one carrying fewer, possibly none.
+    /// The chroma planes are neither read nor written. The workspace and the permutations are kept between frames,
+    /// so that frames of one size are priced and permuted without allocating.
+    class sequence_embedder {
+    public:
+        /// @brief Creates an embedder at the first payload bit
+        /// @param steg_key the key of the pixel permutation, the same for every frame
+        /// @param constraint_height the constraint height of the STC
+        /// @param payload_bits the packed payload bits, copied
+        /// @param frame_bit_count the count of payload bits of each frame, the extractor must agree
+        /// @param options the options of the pipeline, the embedder caches the permutations when none is given
+        sequence_embedder(
+            const std::array<std::uint8_t, 32> steg_key,
+            const std::uint32_t constraint_height,
+            const bit_vector& payload_bits,
+            const std::size_t frame_bit_count,
+            const embed_options& options = embed_options {});
+        sequence_embedder(const sequence_embedder& other) = delete;
+        sequence_embedder& operator=(const sequence_embedder& other) = delete;
+
+        /// @brief Embeds the next payload bits in the luma plane of a frame, frames after the last one are left
+        /// untouched
+        /// @tparam cost_model_t the cost model pricing the luma pixels, a type with a static cost function as
+        /// wow_cost_model
+        /// @param frame the frame
+        /// @param cost_embedded the total price of the changed payload pixels of the frame
+        /// @return true if the stego luma survived the roundtrip to the pixels
+        template <typename cost_model_t>
+        bool embed_frame(const yuv420_frame& frame, double& cost_embedded)
+        {
+            if (!_next_frame_bits(frame)) {
+                cost_embedded = 0.0;
+                return true;
+            }
+            const mutable_image_view luma = luma_view(frame);
+            return embed_luminance<cost_model_t>(luma, _steg_key, _constraint_height, _frame_bits, _options, _memory, luma, cost_embedded);
+        }
+
+        /// @brief Tells whether the last frame of the payload was embedded
+        bool finished() const;
+
+        /// @brief Gets the count of payload bits embedded so far
+        std::size_t embedded_bit_count() const;
+
+    private:
+        /// @brief Takes the payload bits of the next frame, false once the last frame was embedded
+        bool _next_frame_bits(const yuv420_frame& frame);
+
+        std::array<std::uint8_t, 32> _steg_key;
+        std::uint32_t _constraint_height;
+        bit_vector _payload_bits;
+        std::size_t _frame_bit_count;
+        embed_options _options;
+        permutation_cache _permutations;
+        workspace _memory;
+        bit_vector _frame_bits;
+        std::size_t _embedded_bit_count = 0;
+        bool _finished = false;
+    };
+
+    /// @brief Extracts a payload embedded by sequence_embedder, one frame at a time in the order of the embedding
+    class sequence_extractor {
+    public:
+        /// @brief Creates an extractor without payload bits
+        /// @param steg_key the key of the pixel permutation
+        /// @param constraint_height the constraint height of the STC
+        /// @param frame_bit_count the count of payload bits of each frame, as given to the embedder
+        /// @param max_payload_bit_count the upper bound of the payload bit count
+        /// @param options the options of the extraction, the extractor caches the permutations when none is given
+        sequence_extractor(
+            const std::array<std::uint8_t, 32> steg_key,
+            const std::uint32_t constraint_height,
+            const std::size_t frame_bit_count,
+            const std::size_t max_payload_bit_count,
+            const extract_options& options = extract_options {});
+        sequence_extractor(const sequence_extractor& other) = delete;
+        sequence_extractor& operator=(const sequence_extractor& other) = delete;
+
+        /// @brief Appends the payload bits of the luma plane of the next frame, frames after the last one are
+        /// ignored
+        /// @param frame the frame
+        void extract_frame(const yuv420_frame& frame);
+
+        /// @brief Tells whether the last frame of the payload was extracted
+        bool finished() const;
+
+        /// @brief Gets the packed payload bits extracted so far
+        const bit_vector& payload_bits() const;
+
+    private:
+        std::array<std::uint8_t, 32> _steg_key;
+        std::uint32_t _constraint_height;
+        std::size_t _frame_bit_count;
+        std::size_t _max_payload_bit_count;
+        extract_options _options;
+        permutation_cache _permutations;
+        workspace _memory;
+        bit_vector _frame_bits;
+        bit_vector _payload_bits;
+        bool _finished = false;
+    };
+}
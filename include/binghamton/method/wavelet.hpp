@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <binghamton/method/cost.hpp>
+
+namespace binghamton {
+
+    /// @brief Cost computed from the residuals of the Daubechies 8 directional filter bank
+    enum struct wavelet_cost {
+
+        /// @brief Hölder norm with p = -1 of the suitabilities of the absolute residuals (WOW)
+        wow,
+
+        /// @brief Sum of the suitabilities of the inverted absolute residuals, with sigma = 1 (S-UNIWARD)
+        suniward
+    };
+
+    /// @brief Computes the cost of changing each Y pixel from the Daubechies 8 directional filter bank
+    /// @param y the Y pixels to take as input
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param cost_model the way residuals are turned into costs
+    /// @param rho the costs to take as output, 1e10 for wet pixels
+    void cost_wavelet(
+        const std::vector<std::uint8_t>& y,
+        const std::size_t width,
+        const std::size_t height,
+        const wavelet_cost cost_model,
+        std::vector<float>& rho);
+
+    /// @brief Computes the cost of changing each Y pixel from the Daubechies 8 directional filter bank
+    /// @param y the Y pixels to take as input
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param cost_model the way residuals are turned into costs
+    /// @param options the options running the computation
+    /// @param rho the costs to take as output, 1e10 for wet pixels
+    void cost_wavelet(
+        const std::vector<std::uint8_t>& y,
+        const std::size_t width,
+        const std::size_t height,
+        const wavelet_cost cost_model,
+        const cost_options& options,
+        std::vector<float>& rho);
+
+    /// @brief Computes the cost of changing each Y pixel from the Daubechies 8 directional filter bank
+    /// @param y the Y pixels to take as input, width * height of them
+    /// @param width the width of the image
+    /// @param height the height of the image
+    /// @param cost_model the way residuals are turned into costs
+    /// @param options the options running the computation
+    /// @param rho the costs to take as output, width * height of them, 1e10 for wet pixels
+    void cost_wavelet(
+        const std::uint8_t* y,
+        const std::size_t width,
+        const std::size_t height,
+        const wavelet_cost cost_model,
+        const cost_options& options,
+        float* rho);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+#include <binghamton/core/bits.hpp>
+#include <binghamton/core/scratch.hpp>
+
+namespace binghamton {
+
+    /// @brief Memory of the luminance pipeline kept between images. Buffers grow to the largest sizes seen, so
+    /// that once an image size and a payload length were met, embedding or extracting again with the same options
+    /// does not allocate. Running the cost map on a thread pool still allocates the pool jobs. A workspace serves
+    /// one image at a time.
+    struct workspace {
+
+        /// @brief Creates a workspace without memory
+        /// @param resource the memory resource of every buffer
+        explicit workspace(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        workspace(const workspace& other) = delete;
+        workspace& operator=(const workspace& other) = delete;
+
+        /// @brief Gets the count of bytes held by the workspace
+        std::size_t capacity() const;
+
+        /// @brief Gets the memory resource of the buffers
+        std::pmr::memory_resource* resource() const;
+
+        /// @brief Frees every buffer
+        void release();
+
+        /// @brief Planes of one value per pixel, Y, costs, prices and permutation
+        scratch planes;
+
+        /// @brief Rows of the band being streamed, the cover rows with their halo, their Y, costs and prices and
+        /// the stego rows
+        scratch bands;
+
+        /// @brief Scratch of the cost map tiles and of the STC segments
+        scratch_pool tasks;
+
+        /// @brief Packed LSB plane of the image
+        bit_vector symbols;
+
+        /// @brief Packed cover symbols in the order of the STC
+        bit_vector cover_stc;
+
+        /// @brief Packed stego symbols in the order of the STC
+        bit_vector stego_stc;
+    };
+
+    /// @brief Workspaces lent to images processed at the same time, each running image holding its own. The pool
+    /// keeps as many workspaces as images were ever processed at once.
+    class workspace_pool {
+    public:
+        /// @brief Workspace lent to one image, given back to the pool on destruction
+        class lease {
+        public:
+            lease(lease&& other) noexcept;
+            lease(const lease& other) = delete;
+            lease& operator=(const lease& other) = delete;
+            ~lease();
+
+            workspace& operator*() const { return *_workspace; }
+            workspace* operator->() const { return _workspace; }
+
+        private:
+            friend class workspace_pool;
+            lease(workspace_pool* pool, workspace* value);
+
+            workspace_pool* _pool;
+            workspace* _workspace;
+        };
+
+        /// @brief Creates a pool without workspaces
+        /// @param resource the memory resource of the workspaces
+        explicit workspace_pool(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        workspace_pool(const workspace_pool& other) = delete;
+        workspace_pool& operator=(const workspace_pool& other) = delete;
+
+        /// @brief Lends a workspace no other lease holds, the one given back last if any. Thread-safe.
+        lease acquire();
+
+        /// @brief Gets the count of bytes held by the workspaces
+        std::size_t capacity() const;
+
+        /// @brief Gets the memory resource of the workspaces
+        std::pmr::memory_resource* resource() const;
+
+        /// @brief Frees the buffers of every workspace, no lease may be held
+        void release();
+
+    private:
+        std::pmr::memory_resource* _resource;
+        std::pmr::list<workspace> _workspaces;
+        std::pmr::vector<workspace*> _available;
+        mutable std::mutex _mutex;
+    };
+}
@@ -0,0 +1,75 @@
+#include <array>
+
+#include <binghamton/core/bits.hpp>
+
+namespace binghamton {
+namespace {
+
+    // Table of the reflected polynomial 0xedb88320, one entry per byte
+    constexpr std::array<std::uint32_t, 256> _make_crc32_table()
+    {
+        std::array<std::uint32_t, 256> _table {};
+        for (std::uint32_t _byte = 0; _byte < 256; ++_byte) {
+            std::uint32_t _crc = _byte;
+            for (int _bit = 0; _bit < 8; ++_bit) {
+                _crc = (_crc >> 1) ^ (0xedb88320u & (0u - (_crc & 1u)));
+            }
+            _table[_byte] = _crc;
+        }
+        return _table;
+    }
+
+    constexpr std::array<std::uint32_t, 256> _crc32_table = _make_crc32_table();
+
+}
+
+void bit_vector::resize(const std::size_t count)
+{
+    words.resize((count + 63) / 64, 0);
+    size = count;
+    if (count % 64 != 0) {
+        words.back() &= (std::uint64_t(1) << (count % 64)) - 1u;
+    }
+}
+
+void pack_bits(
+    const std::vector<std::uint8_t>& bits,
+    bit_vector& packed)
+{
+    const std::size_t _bits_count = bits.size();
+    packed.words.assign((_bits_count + 63) / 64, 0);
+    packed.size = _bits_count;
+
+    for (std::size_t _word_index = 0; _word_index < packed.words.size(); ++_word_index) {
+        const std::size_t _first_bit = 64 * _word_index;
+        const std::size_t _last_bit = _first_bit + 64 < _bits_count ? _first_bit + 64 : _bits_count;
+        std::uint64_t _word = 0;
+        for (std::size_t _bit_index = _first_bit; _bit_index < _last_bit; ++_bit_index) {
+            _word |= static_cast<std::uint64_t>(bits[_bit_index] & 1u) << (_bit_index - _first_bit);
+        }
+        packed.words[_word_index] = _word;
+    }
+}
+
+void unpack_bits(
+    const bit_vector& packed,
+    std::vector<std::uint8_t>& bits)
+{
+    bits.resize(packed.size);
+    for (std::size_t _bit_index = 0; _bit_index < packed.size; ++_bit_index) {
+        bits[_bit_index] = static_cast<std::uint8_t>((packed.words[_bit_index / 64] >> (_bit_index % 64)) & 1u);
+    }
+}
+
+std::uint32_t crc32(const bit_vector& packed)
+{
+    std::uint32_t _crc = 0xffffffffu;
+    const std::size_t _bytes_count = (packed.size + 7) / 8;
+    for (std::size_t _byte_index = 0; _byte_index < _bytes_count; ++_byte_index) {
+        const std::uint8_t _byte = static_cast<std::uint8_t>(packed.words[_byte_index / 8] >> (8 * (_byte_index % 8)));
+        _crc = (_crc >> 8) ^ _crc32_table[(_crc ^ _byte) & 0xffu];
+    }
+    return _crc ^ 0xffffffffu;
+}
+
+}
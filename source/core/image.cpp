@@ -0,0 +1,56 @@
+#include <stdexcept>
+
+#include <binghamton/core/image.hpp>
+
+namespace binghamton {
+
+std::size_t channels_count(const pixel_layout layout)
+{
+    switch (layout) {
+    case pixel_layout::rgb:
+    case pixel_layout::bgr:
+        return 3;
+    case pixel_layout::rgba:
+    case pixel_layout::bgra:
+        return 4;
+    case pixel_layout::gray:
+        return 1;
+    }
+    throw std::runtime_error("channels_count: unknown pixel layout");
+}
+
+image_view make_image_view(
+    const std::vector<std::uint8_t>& pixels,
+    const std::size_t width,
+    const std::size_t height,
+    const pixel_layout layout)
+{
+    if (pixels.size() != width * height * channels_count(layout)) {
+        throw std::runtime_error("make_image_view: pixels.size() must be equal to width * height * channels_count(layout)");
+    }
+    return image_view { pixels.data(), width, height, width * channels_count(layout), layout };
+}
+
+mutable_image_view make_image_view(
+    std::vector<std::uint8_t>& pixels,
+    const std::size_t width,
+    const std::size_t height,
+    const pixel_layout layout)
+{
+    if (pixels.size() != width * height * channels_count(layout)) {
+        throw std::runtime_error("make_image_view: pixels.size() must be equal to width * height * channels_count(layout)");
+    }
+    return mutable_image_view { pixels.data(), width, height, width * channels_count(layout), layout };
+}
+
+bool is_valid(const image_view& image)
+{
+    return image.data != nullptr && image.stride >= image.width * channels_count(image.layout);
+}
+
+bool is_packed(const image_view& image)
+{
+    return image.stride == image.width * channels_count(image.layout);
+}
+
+}
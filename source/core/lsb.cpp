@@ -17,6 +17,40 @@ void encode_lsb(
     }
 }
 
+void encode_lsb(
+    const std::vector<std::uint8_t>& y,
+    bit_vector& y_lsb)
+{
+    encode_lsb(y.data(), y.size(), y_lsb);
+}
+
+void encode_lsb(
+    const std::uint8_t* y,
+    const std::size_t pixels_count,
+    bit_vector& y_lsb)
+{
+    const std::size_t _pixels_count = pixels_count;
+    const std::size_t _full_words_count = _pixels_count / 64;
+    y_lsb.words.resize((_pixels_count + 63) / 64);
+    y_lsb.size = _pixels_count;
+
+    for (std::size_t _word_index = 0; _word_index < _full_words_count; ++_word_index) {
+        const std::uint8_t* _pixels = y + 64 * _word_index;
+        std::uint64_t _word = 0;
+        for (std::size_t _bit_index = 0; _bit_index < 64; ++_bit_index) {
+            _word |= static_cast<std::uint64_t>(_pixels[_bit_index] & 1u) << _bit_index;
+        }
+        y_lsb.words[_word_index] = _word;
+    }
+    if (_full_words_count != y_lsb.words.size()) {
+        std::uint64_t _word = 0;
+        for (std::size_t _pixel_index = 64 * _full_words_count; _pixel_index < _pixels_count; ++_pixel_index) {
+            _word |= static_cast<std::uint64_t>(y[_pixel_index] & 1u) << (_pixel_index % 64);
+        }
+        y_lsb.words.back() = _word;
+    }
+}
+
 void decode_lsb(
     const std::vector<std::uint8_t>& y,
     const std::vector<std::uint8_t>& y_lsb,
@@ -34,4 +68,33 @@ void decode_lsb(
     }
 }
 
-}
\ No newline at end of file
+void decode_lsb(
+    const std::vector<std::uint8_t>& y,
+    const bit_vector& y_lsb,
+    std::vector<std::uint8_t>& y_embedded)
+{
+    if (y.size() != y_lsb.size) {
+        throw std::runtime_error("y.size() must be equal to y_lsb.size");
+    }
+
+    y_embedded.resize(y_lsb.size);
+    decode_lsb(y.data(), y_lsb, y_embedded.data());
+}
+
+void decode_lsb(
+    const std::uint8_t* y,
+    const bit_vector& y_lsb,
+    std::uint8_t* y_embedded)
+{
+    const std::size_t _pixels_count = y_lsb.size;
+    for (std::size_t _word_index = 0; _word_index < y_lsb.words.size(); ++_word_index) {
+        const std::size_t _first_pixel = 64 * _word_index;
+        const std::size_t _last_pixel = _first_pixel + 64 < _pixels_count ? _first_pixel + 64 : _pixels_count;
+        const std::uint64_t _word = y_lsb.words[_word_index];
+        for (std::size_t _pixel_index = _first_pixel; _pixel_index < _last_pixel; ++_pixel_index) {
+            y_embedded[_pixel_index] = static_cast<std::uint8_t>((y[_pixel_index] & ~1u) | ((_word >> (_pixel_index - _first_pixel)) & 1u));
+        }
+    }
+}
+
+}
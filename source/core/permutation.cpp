@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <binghamton/core/permutation.hpp>
+
+namespace binghamton {
+namespace {
+
+    std::uint64_t _hash_key_to_seed(const std::array<std::uint8_t, 32>& key)
+    {
+        // Simple 64-bit hash / mixer (FNV-1a style + mixing)
+        std::uint64_t h = 0x9e3779b97f4a7c15ULL;
+        for (auto b : key) {
+            h ^= static_cast<std::uint64_t>(b) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        }
+        if (h == 0) {
+            h = 0xdeadbeefcafebabeULL; // avoid zero state
+        }
+        return h;
+    }
+
+    struct StegoRng {
+        std::uint64_t state;
+
+        explicit StegoRng(const std::array<std::uint8_t, 32>& key)
+            : state(_hash_key_to_seed(key))
+        {
+        }
+
+        std::size_t next(std::size_t bound)
+        {
+            // xorshift* PRNG
+            std::uint64_t x = state;
+            x ^= x >> 12;
+            x ^= x << 25;
+            x ^= x >> 27;
+            state = x;
+            std::uint64_t r = x * 2685821657736338717ULL;
+            return static_cast<std::size_t>(r % bound);
+        }
+    };
+
+}
+
+void make_permutation(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t first,
+    const std::size_t count,
+    std::vector<std::size_t>& indices_out)
+{
+    indices_out.resize(count);
+    make_permutation(steg_key, first, count, indices_out.data());
+}
+
+void make_permutation(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t first,
+    const std::size_t count,
+    std::size_t* indices_out)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        indices_out[i] = first + i; // pixel indices [first .. first+count)
+    }
+
+    StegoRng rng(steg_key);
+    // Fisher–Yates shuffle
+    for (std::size_t i = count; i > 1; --i) {
+        std::size_t j = rng.next(i); // 0 <= j < i
+        std::swap(indices_out[i - 1], indices_out[j]);
+    }
+}
+
+feistel_permutation::feistel_permutation(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t first,
+    const std::size_t count)
+    : _first(first)
+    , _count(count)
+    , _half_bits(1)
+{
+    // Each half holds at least one bit, so that the domain [0, 4^_half_bits) is below 4 * count
+    // and walking a cycle back under count takes fewer than 4 rounds of the network on average
+    while ((std::uint64_t(1) << (2 * _half_bits)) < _count) {
+        ++_half_bits;
+    }
+    _half_mask = (std::uint64_t(1) << _half_bits) - 1;
+
+    // Splitmix64 sequence seeded by the key, mixed with the range so that another image size
+    // gives unrelated round keys. Seeded apart from the shuffle so that both never correlate.
+    std::uint64_t _state = _hash_key_to_seed(steg_key) ^ 0x6a09e667f3bcc909ULL;
+    _state ^= (static_cast<std::uint64_t>(first) << 32) ^ static_cast<std::uint64_t>(count);
+    for (std::uint64_t& _round_key : _round_keys) {
+        _state += 0x9e3779b97f4a7c15ULL;
+        std::uint64_t _mixed = _state;
+        _mixed = (_mixed ^ (_mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        _mixed = (_mixed ^ (_mixed >> 27)) * 0x94d049bb133111ebULL;
+        _round_key = _mixed ^ (_mixed >> 31);
+    }
+}
+
+void make_blocked_permutation(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t first,
+    const std::size_t count,
+    std::size_t* indices_out,
+    const std::size_t block_size)
+{
+    if (block_size == 0) {
+        throw std::runtime_error("make_blocked_permutation: block_size cannot be 0");
+    }
+
+    // The block order has its own key so that it never correlates with the shuffles
+    std::array<std::uint8_t, 32> _blocks_key = steg_key;
+    _blocks_key[0] ^= 0xb1;
+    const std::size_t _full_blocks_count = count / block_size;
+    const feistel_permutation _blocks(_blocks_key, 0, _full_blocks_count);
+
+    StegoRng rng(steg_key);
+    for (std::size_t _block = 0; _block * block_size < count; ++_block) {
+        const std::size_t _first_position = _block * block_size;
+        const std::size_t _block_count = std::min(block_size, count - _first_position);
+        const std::size_t _first_pixel = first + block_size * (_block < _full_blocks_count ? _blocks(_block) : _block);
+        std::size_t* _indices = indices_out + _first_position;
+        for (std::size_t i = 0; i < _block_count; ++i) {
+            _indices[i] = _first_pixel + i;
+        }
+        // Fisher–Yates shuffle inside the block, which stays in cache
+        for (std::size_t i = _block_count; i > 1; --i) {
+            std::size_t j = rng.next(i);
+            std::swap(_indices[i - 1], _indices[j]);
+        }
+    }
+}
+
+void make_key_stream(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t count,
+    std::uint64_t* words_out)
+{
+    // Splitmix64 sequence seeded by the key
+    std::uint64_t _state = _hash_key_to_seed(steg_key) ^ 0xbb67ae8584caa73bULL;
+    for (std::size_t i = 0; i < count; ++i) {
+        _state += 0x9e3779b97f4a7c15ULL;
+        std::uint64_t _mixed = _state;
+        _mixed = (_mixed ^ (_mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        _mixed = (_mixed ^ (_mixed >> 27)) * 0x94d049bb133111ebULL;
+        words_out[i] = _mixed ^ (_mixed >> 31);
+    }
+}
+
+struct permutation_cache::entry {
+    std::once_flag computed;
+    std::vector<std::size_t> indices;
+    std::uint64_t last_use = 0;
+};
+
+permutation_cache::permutation_cache(const std::size_t byte_limit)
+    : _byte_limit(byte_limit)
+{
+}
+
+std::shared_ptr<const std::vector<std::size_t>> permutation_cache::get(
+    const std::array<std::uint8_t, 32>& steg_key,
+    const std::size_t first,
+    const std::size_t count,
+    const permutation_version version)
+{
+    if (version == permutation_version::feistel) {
+        throw std::runtime_error("permutation_cache: the feistel permutation has no table");
+    }
+
+    std::shared_ptr<entry> _entry;
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        const key_type _key(steg_key, first, count, version);
+        std::shared_ptr<entry>& _slot = _entries[_key];
+        if (!_slot) {
+            _slot = std::make_shared<entry>();
+            _bytes += count * sizeof(std::size_t);
+        }
+        _slot->last_use = ++_uses_count;
+        _entry = _slot;
+
+        // Dropping a table only releases the cache reference, its current holders keep it alive
+        while (_byte_limit != 0 && _bytes > _byte_limit && _entries.size() > 1) {
+            auto _oldest = _entries.end();
+            for (auto _iterator = _entries.begin(); _iterator != _entries.end(); ++_iterator) {
+                if (_iterator->first != _key && (_oldest == _entries.end() || _iterator->second->last_use < _oldest->second->last_use)) {
+                    _oldest = _iterator;
+                }
+            }
+            _bytes -= std::get<2>(_oldest->first) * sizeof(std::size_t);
+            _entries.erase(_oldest);
+        }
+    }
+
+    // The shuffle runs outside the lock so that other permutations are served meanwhile
+    std::call_once(_entry->computed, [&]() {
+        if (version == permutation_version::blocked) {
+            _entry->indices.resize(count);
+            make_blocked_permutation(steg_key, first, count, _entry->indices.data());
+        } else {
+            make_permutation(steg_key, first, count, _entry->indices);
+        }
+    });
+    return std::shared_ptr<const std::vector<std::size_t>>(_entry, &_entry->indices);
+}
+
+std::size_t permutation_cache::size() const
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    return _entries.size();
+}
+
+std::size_t permutation_cache::bytes() const
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    return _bytes;
+}
+
+void permutation_cache::clear()
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    _entries.clear();
+    _bytes = 0;
+}
+
+}
@@ -0,0 +1,124 @@
+#include <binghamton/core/scratch.hpp>
+
+namespace binghamton {
+
+scratch::scratch(std::pmr::memory_resource* resource)
+    : _resource(resource)
+    , _buffers(resource)
+{
+}
+
+scratch::~scratch()
+{
+    release();
+}
+
+void* scratch::_get(const std::size_t index, const std::size_t bytes)
+{
+    if (index >= _buffers.size()) {
+        _buffers.resize(index + 1);
+    }
+    buffer& _buffer = _buffers[index];
+    if (_buffer.bytes < bytes) {
+        if (_buffer.data != nullptr) {
+            _resource->deallocate(_buffer.data, _buffer.bytes, scratch_alignment);
+            _buffer.data = nullptr;
+            _buffer.bytes = 0;
+        }
+        _buffer.data = _resource->allocate(bytes, scratch_alignment);
+        _buffer.bytes = bytes;
+    }
+    return _buffer.data;
+}
+
+std::size_t scratch::capacity() const
+{
+    std::size_t _bytes = 0;
+    for (const buffer& _buffer : _buffers) {
+        _bytes += _buffer.bytes;
+    }
+    return _bytes;
+}
+
+std::pmr::memory_resource* scratch::resource() const
+{
+    return _resource;
+}
+
+void scratch::release()
+{
+    for (buffer& _buffer : _buffers) {
+        if (_buffer.data != nullptr) {
+            _resource->deallocate(_buffer.data, _buffer.bytes, scratch_alignment);
+        }
+    }
+    _buffers.clear();
+}
+
+scratch_pool::lease::lease(scratch_pool* pool, scratch* value)
+    : _pool(pool)
+    , _scratch(value)
+{
+}
+
+scratch_pool::lease::lease(lease&& other) noexcept
+    : _pool(other._pool)
+    , _scratch(other._scratch)
+{
+    other._pool = nullptr;
+    other._scratch = nullptr;
+}
+
+scratch_pool::lease::~lease()
+{
+    if (_pool != nullptr) {
+        // _available was grown with _scratches, giving a scratch back never allocates
+        std::lock_guard<std::mutex> _lock(_pool->_mutex);
+        _pool->_available.push_back(_scratch);
+    }
+}
+
+scratch_pool::scratch_pool(std::pmr::memory_resource* resource)
+    : _resource(resource)
+    , _scratches(resource)
+    , _available(resource)
+{
+}
+
+scratch_pool::lease scratch_pool::acquire()
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    if (_available.empty()) {
+        _scratches.emplace_back(_resource);
+        _available.reserve(_scratches.size());
+        return lease(this, &_scratches.back());
+    }
+    scratch* _scratch = _available.back();
+    _available.pop_back();
+    return lease(this, _scratch);
+}
+
+std::size_t scratch_pool::capacity() const
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    std::size_t _bytes = 0;
+    for (const scratch& _scratch : _scratches) {
+        _bytes += _scratch.capacity();
+    }
+    return _bytes;
+}
+
+std::pmr::memory_resource* scratch_pool::resource() const
+{
+    return _resource;
+}
+
+void scratch_pool::release()
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    for (scratch& _scratch : _scratches) {
+        _scratch.release();
+    }
+}
+
+}
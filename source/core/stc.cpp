@@ -1,25 +1,702 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
+#include <cmath>
+#include <cstring>
+#include <functional>
 #include <limits>
+#include <new>
 #include <stdexcept>
+#include <utility>
 
 #include <binghamton/core/stc.hpp>
 
-// TODO
+// Syndrome-trellis codes as described in
 // https://staff.emu.edu.tr/alexanderchefranov/Documents/CMSE492/Spring2019/FillerIEEETIFS2011%20Minimizing%20Additive%20Distortion%20in%20Steganography.pdf
 
 namespace binghamton {
 namespace {
 
-    namespace {
-        inline std::uint8_t _bit_from_symbol(std::int8_t v)
+    constexpr std::uint32_t _max_constraint_height = 15;
+
+    // Buffers of the scratch of one segment
+    enum _segment_buffer : std::size_t {
+        _hhat_buffer,
+        _checkpoints_buffer,
+        _path_buffer,
+        _trellis_buffer,
+        _tables_buffer,
+        _rows_buffer
+    };
+
+    // Buffers of the scratch holding the output of every segment until they are merged
+    enum _merge_buffer : std::size_t {
+        _segment_words_buffer,
+        _segment_prices_buffer
+    };
+
+    inline std::uint64_t _splitmix64(std::uint64_t& state)
+    {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Builds the H-hat submatrix shared by encoder and decoder. Each column is a
+    // constraint_height bit mask (bit r = row r of the band) with its first and
+    // last rows set, which keeps every block able to reach any syndrome bit and
+    // is the random construction recommended by Filler et al. for arbitrary sizes.
+    void _make_hhat(
+        const std::uint32_t constraint_height,
+        const std::size_t width,
+        std::uint32_t* columns)
+    {
+        const std::uint32_t full_mask = (1u << constraint_height) - 1u;
+        const std::uint32_t edge_mask = 1u | (1u << (constraint_height - 1));
+
+        std::uint64_t state = (static_cast<std::uint64_t>(constraint_height) << 32) ^ static_cast<std::uint64_t>(width);
+        for (std::size_t k = 0; k < width; ++k) {
+            columns[k] = (static_cast<std::uint32_t>(_splitmix64(state)) & full_mask) | edge_mask;
+        }
+    }
+
+    // Block i spans cover columns [_block_start(i), _block_start(i + 1)) so that the
+    // n columns are spread as evenly as possible over the m syndrome bits.
+    inline std::size_t _block_start(std::size_t i, std::size_t n, std::size_t m)
+    {
+        return (i * n) / m;
+    }
+
+    inline std::size_t _hhat_width(std::size_t n, std::size_t m)
+    {
+        return (n + m - 1) / m;
+    }
+
+    // Reads count bits (1 to 64) starting at any bit position of a packed vector.
+    inline std::uint64_t _extract_bits(const std::uint64_t* words, std::size_t position, std::size_t count)
+    {
+        const std::size_t word_index = position / 64;
+        const std::size_t shift = position % 64;
+        std::uint64_t bits = words[word_index] >> shift;
+        if (shift != 0 && shift + count > 64) {
+            bits |= words[word_index + 1] << (64 - shift);
+        }
+        return count < 64 ? bits & ((std::uint64_t(1) << count) - 1u) : bits;
+    }
+
+    // Steps through the block bounds _block_start(i, n, m) without a division per block.
+    struct _block_walker {
+        std::size_t quotient;
+        std::size_t remainder;
+        std::size_t m;
+        std::size_t accumulator = 0;
+        std::size_t end = 0;
+
+        _block_walker(std::size_t n, std::size_t m)
+            : quotient(n / m)
+            , remainder(n % m)
+            , m(m)
         {
-            return static_cast<std::uint8_t>(v & 1);
         }
 
-        inline std::uint8_t _bit_from_symbol(std::uint8_t v)
+        std::size_t next()
         {
-            return v & 1u;
+            end += quotient;
+            accumulator += remainder;
+            if (accumulator >= m) {
+                accumulator -= m;
+                ++end;
+            }
+            return end;
+        }
+    };
+
+    // Bit j of the result is the parity of bits 0 to j of the word.
+    inline std::uint64_t _prefix_parity(std::uint64_t word)
+    {
+        word ^= word << 1;
+        word ^= word << 2;
+        word ^= word << 4;
+        word ^= word << 8;
+        word ^= word << 16;
+        word ^= word << 32;
+        return word;
+    }
+
+    inline bool _get_bit(const std::uint64_t* words, std::size_t position)
+    {
+        return (words[position / 64] >> (position % 64)) & 1u;
+    }
+
+    // Writes count bits (1 to 64) at any bit position of a packed vector.
+    inline void _deposit_bits(std::uint64_t* words, std::size_t position, std::uint64_t bits, std::size_t count)
+    {
+        const std::size_t word_index = position / 64;
+        const std::size_t shift = position % 64;
+        const std::uint64_t mask = count < 64 ? (std::uint64_t(1) << count) - 1u : ~std::uint64_t(0);
+        words[word_index] = (words[word_index] & ~(mask << shift)) | ((bits & mask) << shift);
+        if (shift != 0 && shift + count > 64) {
+            words[word_index + 1] = (words[word_index + 1] & ~(mask >> (64 - shift))) | ((bits & mask) >> (64 - shift));
+        }
+    }
+
+    void _copy_bits(
+        const std::uint64_t* source,
+        const std::size_t source_position,
+        const std::size_t count,
+        std::uint64_t* destination,
+        const std::size_t destination_position)
+    {
+        for (std::size_t offset = 0; offset < count; offset += 64) {
+            const std::size_t chunk = std::min<std::size_t>(count - offset, 64);
+            _deposit_bits(destination, destination_position + offset, _extract_bits(source, source_position + offset, chunk), chunk);
+        }
+    }
+
+    // Cover and syndrome bits are read from packed vectors starting at their first
+    // position, stego bits are written from bit 0 of a zeroed packed vector of n bits.
+    // Symbols priced wet are never changed, wet is 256 when no price is wet.
+    double _encode_parity(
+        const std::uint64_t* cover_words,
+        const std::size_t cover_first,
+        const std::size_t n,
+        const std::uint64_t* syndrome_words,
+        const std::size_t syndrome_first,
+        const std::size_t m,
+        const std::uint8_t* pricevector,
+        const std::uint32_t wet,
+        std::uint64_t* stego_words)
+    {
+        // Block partition: n positions -> m blocks (almost equal size)
+        const std::size_t base_block_size = n / m;
+        const std::size_t remainder = n % m; // first 'remainder' blocks get +1 element
+
+        // Start stego as copy of cover bits
+        _copy_bits(cover_words, cover_first, n, stego_words, 0);
+
+        double total_price = 0.0;
+
+        std::size_t idx = 0;
+        for (std::size_t bit_idx = 0; bit_idx < m; ++bit_idx) {
+            const std::size_t this_block_size = base_block_size + (bit_idx < remainder ? 1 : 0);
+
+            const std::size_t start = idx;
+            const std::size_t end = idx + this_block_size;
+            idx = end;
+
+            if (start >= end)
+                break; // no more room
+
+            const std::uint32_t target_bit = _get_bit(syndrome_words, syndrome_first + bit_idx);
+
+            // Compute parity of this block, a word at a time
+            std::uint64_t folded = 0;
+            for (std::size_t i = start; i < end; i += 64)
+                folded ^= _extract_bits(stego_words, i, std::min<std::size_t>(end - i, 64));
+
+            if (parity(folded) == target_bit) {
+                // Block already encodes the bit; nothing to do.
+                continue;
+            }
+
+            // Need to flip one symbol; pick minimal cost in this block
+            float best_cost = std::numeric_limits<float>::infinity();
+            std::size_t best_idx = end; // invalid
+
+            for (std::size_t i = start; i < end; ++i) {
+                const float c = pricevector[i] != wet ? static_cast<float>(pricevector[i]) : best_cost;
+                if (c < best_cost) {
+                    best_cost = c;
+                    best_idx = i;
+                }
+            }
+
+            if (best_idx == end)
+                throw std::runtime_error("stc_encode: no valid position found in block");
+
+            // Flip that bit
+            stego_words[best_idx / 64] ^= std::uint64_t(1) << (best_idx % 64);
+            total_price += static_cast<double>(pricevector[best_idx]);
+        }
+
+        return total_price;
+    }
+
+    inline std::uint32_t _row_mask(std::size_t rows_left, std::uint32_t constraint_height)
+    {
+        return rows_left >= constraint_height
+            ? (1u << constraint_height) - 1u
+            : (1u << rows_left) - 1u;
+    }
+
+    inline bool _is_little_endian()
+    {
+        const std::uint16_t probe = 1;
+        std::uint8_t first_byte;
+        std::memcpy(&first_byte, &probe, 1);
+        return first_byte == 1;
+    }
+
+    // Packs 8 flags holding 0 or 1 into the bits of one byte, flag k going to bit k.
+    inline std::uint8_t _pack_flags(const std::uint8_t* flags)
+    {
+        static const bool little_endian = _is_little_endian();
+        if (little_endian) {
+            std::uint64_t word;
+            std::memcpy(&word, flags, sizeof(word));
+            return static_cast<std::uint8_t>((word * 0x0102040810204080ULL) >> 56);
+        }
+        std::uint8_t byte = 0;
+        for (std::uint32_t k = 0; k < 8; ++k) {
+            byte |= static_cast<std::uint8_t>(flags[k] << k);
+        }
+        return byte;
+    }
+
+    // Trellis storage for one constraint height, the state count being a
+    // compile-time constant lets every loop over the states be unrolled and
+    // vectorized by the compiler.
+    template <std::uint32_t constraint_height>
+    struct _trellis {
+        static constexpr std::size_t states_count = std::size_t(1) << constraint_height;
+        static constexpr std::size_t lanes_count = states_count < 4 ? states_count : 4;
+        static constexpr std::size_t path_bytes_per_column = (states_count + 7) / 8;
+
+        alignas(64) std::array<float, states_count> costs;
+        alignas(64) std::array<float, states_count> next_costs;
+        alignas(64) std::array<std::uint32_t, states_count> take_one;
+        alignas(64) std::array<std::uint8_t, states_count < 8 ? 8 : states_count> take_one_bytes;
+    };
+
+    // Add-compare-select of one column. States are walked in groups of lanes_count
+    // so that s ^ column only permutes lanes inside a group by the compile-time
+    // pattern low_bits, and moves whole groups by the rest of the column.
+    template <std::uint32_t constraint_height, std::uint32_t low_bits>
+    void _add_compare_select(
+        const float* BINGHAMTON_RESTRICT costs,
+        float* BINGHAMTON_RESTRICT next_costs,
+        std::uint32_t* BINGHAMTON_RESTRICT take_one,
+        std::uint8_t* BINGHAMTON_RESTRICT take_one_bytes,
+        const std::uint32_t column,
+        const float price_zero,
+        const float price_one,
+        std::uint8_t* column_path)
+    {
+        using trellis_t = _trellis<constraint_height>;
+        constexpr std::size_t lanes_count = trellis_t::lanes_count;
+        const std::size_t high_bits = column & ~static_cast<std::uint32_t>(lanes_count - 1);
+
+        for (std::size_t group = 0; group < trellis_t::states_count; group += lanes_count) {
+            const float* other_costs = costs + (group ^ high_bits);
+            float permuted_costs[lanes_count];
+            for (std::size_t lane = 0; lane < lanes_count; ++lane) {
+                permuted_costs[lane] = other_costs[lane ^ (low_bits & (lanes_count - 1))];
+            }
+            for (std::size_t lane = 0; lane < lanes_count; ++lane) {
+                const float cost_zero = costs[group + lane] + price_zero;
+                const float cost_one = permuted_costs[lane] + price_one;
+                const bool take = cost_one < cost_zero;
+                next_costs[group + lane] = take ? cost_one : cost_zero;
+                take_one[group + lane] = static_cast<std::uint32_t>(take);
+            }
+        }
+        // Narrowing first keeps both loops free of mixed element sizes.
+        for (std::size_t s = 0; s < trellis_t::states_count; ++s) {
+            take_one_bytes[s] = static_cast<std::uint8_t>(take_one[s]);
+        }
+        for (std::size_t byte = 0; byte < trellis_t::path_bytes_per_column; ++byte) {
+            column_path[byte] = _pack_flags(take_one_bytes + 8 * byte);
+        }
+    }
+
+    using _add_compare_select_t = void (*)(
+        const float*,
+        float*,
+        std::uint32_t*,
+        std::uint8_t*,
+        const std::uint32_t,
+        const float,
+        const float,
+        std::uint8_t*);
+
+    // Selecting the low_bits pattern through a table rather than a switch keeps each
+    // kernel out of line, which lets the compiler honor the restrict qualifiers.
+    template <std::uint32_t constraint_height>
+    constexpr _add_compare_select_t _add_compare_select_table[4] = {
+        &_add_compare_select<constraint_height, 0>,
+        &_add_compare_select<constraint_height, 1>,
+        &_add_compare_select<constraint_height, 2>,
+        &_add_compare_select<constraint_height, 3>,
+    };
+
+    // Picks how many blocks the encoder keeps survivor paths for at once. The whole
+    // trellis fits when path_memory_limit allows it, otherwise the largest segment
+    // whose path bits plus the cost checkpoints of every segment boundary fit.
+    std::size_t _blocks_per_segment(
+        const std::size_t n,
+        const std::size_t m,
+        const std::size_t states_count,
+        const std::size_t path_bytes_per_column,
+        const std::size_t path_memory_limit)
+    {
+        if (path_memory_limit == 0 || path_memory_limit >= n * path_bytes_per_column) {
+            return m;
+        }
+
+        const std::size_t width = _hhat_width(n, m);
+        const auto memory = [&](std::size_t blocks) {
+            const std::size_t checkpoints_count = (m + blocks - 1) / blocks - 1;
+            return checkpoints_count * states_count * sizeof(float)
+                + std::min(blocks * width, n) * path_bytes_per_column;
+        };
+
+        // memory() is convex in the segment length, smallest around this balance point
+        const double balance = std::sqrt(static_cast<double>(m) * static_cast<double>(states_count * sizeof(float))
+            / static_cast<double>(width * path_bytes_per_column));
+        std::size_t low = std::min(m, std::max<std::size_t>(1, static_cast<std::size_t>(balance)));
+        if (memory(low) > path_memory_limit) {
+            throw std::runtime_error("stc_encode: path_memory_limit is too small for this constraint height");
+        }
+
+        std::size_t high = m;
+        while (low < high) {
+            const std::size_t middle = low + (high - low + 1) / 2;
+            if (memory(middle) <= path_memory_limit) {
+                low = middle;
+            } else {
+                high = middle - 1;
+            }
+        }
+        return low;
+    }
+
+    template <std::uint32_t constraint_height>
+    double _encode_trellis(
+        const std::uint64_t* cover_words,
+        const std::size_t cover_first,
+        const std::size_t n,
+        const std::uint64_t* syndrome_words,
+        const std::size_t syndrome_first,
+        const std::size_t m,
+        const std::uint8_t* pricevector,
+        const std::uint32_t wet,
+        const std::size_t path_memory_limit,
+        scratch& memory,
+        std::uint64_t* stego_words)
+    {
+        using trellis_t = _trellis<constraint_height>;
+        constexpr std::size_t states_count = trellis_t::states_count;
+        constexpr std::size_t half_states = states_count / 2;
+        constexpr std::size_t path_bytes_per_column = trellis_t::path_bytes_per_column;
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+
+        const std::size_t width = _hhat_width(n, m);
+        std::uint32_t* hhat = memory.get<std::uint32_t>(_hhat_buffer, width);
+        _make_hhat(constraint_height, width, hhat);
+
+        // Survivor paths are kept for one segment of blocks at a time, the costs
+        // reached at every segment boundary are checkpointed so that earlier
+        // segments can be recomputed exactly while back-tracking.
+        const std::size_t blocks_per_segment = _blocks_per_segment(n, m, states_count, path_bytes_per_column, path_memory_limit);
+        const std::size_t segments_count = (m + blocks_per_segment - 1) / blocks_per_segment;
+        float* checkpoints = memory.get<float>(_checkpoints_buffer, (segments_count - 1) * states_count);
+
+        // One survivor bit per state and column: 1 when the best path into that
+        // state sets the stego symbol of the column.
+        std::uint8_t* path = memory.get<std::uint8_t>(_path_buffer, std::min(blocks_per_segment * width, n) * path_bytes_per_column);
+        trellis_t* trellis = new (memory.get<trellis_t>(_trellis_buffer, 1)) trellis_t;
+        trellis->take_one_bytes.fill(0);
+        float* costs = trellis->costs.data();
+        float* next_costs = trellis->next_costs.data();
+        std::uint32_t* take_one = trellis->take_one.data();
+        std::uint8_t* take_one_bytes = trellis->take_one_bytes.data();
+
+        // Forward pass over blocks [first_block, last_block): add-compare-select over
+        // every state for each column, then prune the states that disagree with the
+        // syndrome bit of the block.
+        const auto forward = [&](const std::size_t first_block, const std::size_t last_block) {
+            const std::size_t first_column = _block_start(first_block, n, m);
+            for (std::size_t i = first_block; i < last_block; ++i) {
+                const std::size_t start = _block_start(i, n, m);
+                const std::size_t end = _block_start(i + 1, n, m);
+                const std::uint32_t row_mask = _row_mask(m - i, constraint_height);
+
+                for (std::size_t j = start; j < end; ++j) {
+                    const std::uint32_t column = hhat[j - start] & row_mask;
+                    const float price = pricevector[j] != wet ? static_cast<float>(pricevector[j]) : infinity;
+                    const bool cover_bit = _get_bit(cover_words, cover_first + j);
+                    const float price_zero = cover_bit ? price : 0.0f;
+                    const float price_one = cover_bit ? 0.0f : price;
+                    std::uint8_t* column_path = &path[(j - first_column) * path_bytes_per_column];
+
+                    const std::uint32_t low_bits = column & static_cast<std::uint32_t>(trellis_t::lanes_count - 1);
+                    _add_compare_select_table<constraint_height>[low_bits](
+                        costs, next_costs, take_one, take_one_bytes, column, price_zero, price_one, column_path);
+                    std::swap(costs, next_costs);
+                }
+
+                const std::size_t message_bit = _get_bit(syndrome_words, syndrome_first + i);
+                float min_cost = infinity;
+                for (std::size_t s = 0; s < half_states; ++s) {
+                    next_costs[s] = costs[2 * s + message_bit];
+                    min_cost = std::min(min_cost, next_costs[s]);
+                }
+                if (!(min_cost < infinity)) {
+                    throw std::runtime_error("stc_encode: no valid path through the trellis");
+                }
+                // Renormalizing keeps float costs small enough to be compared exactly.
+                for (std::size_t s = 0; s < half_states; ++s) {
+                    next_costs[s] -= min_cost;
+                }
+                for (std::size_t s = half_states; s < states_count; ++s) {
+                    next_costs[s] = infinity;
+                }
+                std::swap(costs, next_costs);
+            }
+        };
+
+        // Back-tracking over blocks [first_block, last_block) from the state reached
+        // after last_block, returns the state reached before first_block.
+        double total_price = 0.0;
+        const auto backward = [&](const std::size_t first_block, const std::size_t last_block, std::size_t state) {
+            const std::size_t first_column = _block_start(first_block, n, m);
+            for (std::size_t i = last_block; i-- > first_block;) {
+                const std::size_t start = _block_start(i, n, m);
+                const std::size_t end = _block_start(i + 1, n, m);
+                const std::uint32_t row_mask = _row_mask(m - i, constraint_height);
+
+                state = (state << 1) | static_cast<std::size_t>(_get_bit(syndrome_words, syndrome_first + i));
+                for (std::size_t j = end; j-- > start;) {
+                    const std::uint8_t* column_path = &path[(j - first_column) * path_bytes_per_column];
+                    const std::uint8_t stego_bit = static_cast<std::uint8_t>((column_path[state / 8] >> (state % 8)) & 1u);
+                    if (stego_bit) {
+                        state ^= hhat[j - start] & row_mask;
+                    }
+                    stego_words[j / 64] |= static_cast<std::uint64_t>(stego_bit) << (j % 64);
+                    if ((stego_bit != 0) != _get_bit(cover_words, cover_first + j)) {
+                        total_price += static_cast<double>(pricevector[j]);
+                    }
+                }
+            }
+            return state;
+        };
+
+        const auto restore = [&](const std::size_t segment) {
+            if (segment == 0) {
+                std::fill(costs, costs + states_count, infinity);
+                costs[0] = 0.0f;
+            } else {
+                const float* checkpoint = &checkpoints[(segment - 1) * states_count];
+                std::copy(checkpoint, checkpoint + states_count, costs);
+            }
+        };
+
+        // 1. Forward pass over the whole cover, saving the segment boundaries.
+        restore(0);
+        for (std::size_t segment = 0; segment < segments_count; ++segment) {
+            if (segment > 0) {
+                std::copy(costs, costs + states_count, &checkpoints[(segment - 1) * states_count]);
+            }
+            forward(segment * blocks_per_segment, std::min(m, (segment + 1) * blocks_per_segment));
+        }
+
+        // 2. Back-tracking from the only state that satisfies the whole syndrome. The
+        // last segment still has its paths, earlier ones are recomputed from checkpoints.
+        std::size_t state = 0;
+        for (std::size_t segment = segments_count; segment-- > 0;) {
+            const std::size_t first_block = segment * blocks_per_segment;
+            const std::size_t last_block = std::min(m, first_block + blocks_per_segment);
+            if (segment + 1 < segments_count) {
+                restore(segment);
+                forward(first_block, last_block);
+            }
+            state = backward(first_block, last_block, state);
+        }
+        assert(state == 0);
+
+        return total_price;
+    }
+
+    using _encode_trellis_t = double (*)(
+        const std::uint64_t*,
+        const std::size_t,
+        const std::size_t,
+        const std::uint64_t*,
+        const std::size_t,
+        const std::size_t,
+        const std::uint8_t*,
+        const std::uint32_t,
+        const std::size_t,
+        scratch&,
+        std::uint64_t*);
+
+    template <std::size_t... heights>
+    constexpr std::array<_encode_trellis_t, sizeof...(heights)> _make_encode_trellis_table(std::index_sequence<heights...>)
+    {
+        return { { &_encode_trellis<static_cast<std::uint32_t>(heights + 1)>... } };
+    }
+
+    // Kernels instantiated for every supported height, indexed by constraint_height - 1.
+    constexpr std::array<_encode_trellis_t, _max_constraint_height> _encode_trellis_table
+        = _make_encode_trellis_table(std::make_index_sequence<_max_constraint_height> {});
+
+    void _decode_parity(
+        const std::uint64_t* stego_words,
+        const std::size_t words_count,
+        const std::size_t first_column,
+        const std::size_t n,
+        const std::size_t m,
+        std::uint64_t* syndrome_words)
+    {
+        // The remainder blocks of one more element come first, as in _encode_parity
+        const std::size_t base_block_size = n / m;
+        const std::size_t remainder = n % m;
+
+        // The parity of a block is the XOR of the prefix parities at its bounds, and
+        // the prefix parities are computed a whole word at a time.
+        std::size_t word_index = first_column / 64;
+        std::uint64_t prefix = _prefix_parity(stego_words[word_index]);
+        std::uint32_t carry = 0;
+        const auto prefix_parity_before = [&](std::size_t position) -> std::uint32_t {
+            while (word_index < position / 64) {
+                carry ^= static_cast<std::uint32_t>(prefix >> 63);
+                ++word_index;
+                prefix = word_index < words_count ? _prefix_parity(stego_words[word_index]) : 0;
+            }
+            const std::size_t bit = position % 64;
+            return bit == 0 ? carry : carry ^ static_cast<std::uint32_t>((prefix >> (bit - 1)) & 1u);
+        };
+
+        std::size_t idx = first_column;
+        std::uint32_t parity_start = prefix_parity_before(idx);
+        for (std::size_t bit_idx = 0; bit_idx < m; ++bit_idx) {
+            idx += base_block_size + (bit_idx < remainder ? 1 : 0);
+            const std::uint32_t parity_end = prefix_parity_before(idx);
+            syndrome_words[bit_idx / 64] |= static_cast<std::uint64_t>(parity_start ^ parity_end) << (bit_idx % 64);
+            parity_start = parity_end;
+        }
+    }
+
+    void _decode_trellis(
+        const std::uint64_t* stego_words,
+        const std::size_t first_column,
+        const std::size_t n,
+        const std::size_t m,
+        const std::uint32_t constraint_height,
+        scratch& memory,
+        std::uint64_t* syndrome_words)
+    {
+        const std::size_t width = _hhat_width(n, m);
+        std::uint32_t* hhat = memory.get<std::uint32_t>(_hhat_buffer, width);
+        _make_hhat(constraint_height, width, hhat);
+
+        // The contribution of a block is the XOR of the H-hat columns of its set bits.
+        // Narrow blocks fold it byte by byte through tables of every 8-column XOR,
+        // wide blocks use the transposed H-hat where row r of the band is a mask over
+        // the block columns, so that its bit is the parity of (row & block bits).
+        constexpr std::size_t max_table_width = 64;
+        const std::size_t chunks_count = (width + 63) / 64;
+        const bool use_tables = width <= max_table_width;
+        std::uint32_t* tables = nullptr;
+        std::uint64_t* rows = nullptr;
+        if (use_tables) {
+            const std::size_t bytes_count = (width + 7) / 8;
+            tables = memory.get<std::uint32_t>(_tables_buffer, bytes_count * 256);
+            std::fill(tables, tables + bytes_count * 256, 0u);
+            for (std::size_t byte_index = 0; byte_index < bytes_count; ++byte_index) {
+                std::uint32_t* table = tables + 256 * byte_index;
+                for (std::size_t bit = 0; bit < 8 && 8 * byte_index + bit < width; ++bit) {
+                    const std::uint32_t column = hhat[8 * byte_index + bit];
+                    const std::size_t step = std::size_t(1) << bit;
+                    for (std::size_t value = step; value < 2 * step; ++value) {
+                        table[value] = table[value - step] ^ column;
+                    }
+                }
+            }
+        } else {
+            rows = memory.get<std::uint64_t>(_rows_buffer, constraint_height * chunks_count);
+            std::fill(rows, rows + constraint_height * chunks_count, std::uint64_t(0));
+            for (std::size_t k = 0; k < width; ++k) {
+                for (std::uint32_t r = 0; r < constraint_height; ++r) {
+                    rows[r * chunks_count + k / 64] |= static_cast<std::uint64_t>((hhat[k] >> r) & 1u) << (k % 64);
+                }
+            }
+        }
+
+        _block_walker walker(n, m);
+        std::size_t start = 0;
+        std::uint32_t window = 0;
+        for (std::size_t i = 0; i < m; ++i) {
+            const std::size_t end = walker.next();
+            if (use_tables) {
+                std::uint64_t bits = _extract_bits(stego_words, first_column + start, end - start);
+                for (const std::uint32_t* table = tables; bits != 0; table += 256, bits >>= 8) {
+                    window ^= table[bits & 0xffu];
+                }
+            } else {
+                for (std::size_t chunk = 0; start + 64 * chunk < end; ++chunk) {
+                    const std::size_t position = start + 64 * chunk;
+                    const std::uint64_t bits = _extract_bits(stego_words, first_column + position, std::min<std::size_t>(end - position, 64));
+                    if (bits == 0) {
+                        continue;
+                    }
+                    for (std::uint32_t r = 0; r < constraint_height; ++r) {
+                        window ^= parity(bits & rows[r * chunks_count + chunk]) << r;
+                    }
+                }
+            }
+            syndrome_words[i / 64] |= static_cast<std::uint64_t>(window & 1u) << (i % 64);
+            window >>= 1;
+            start = end;
+        }
+    }
+
+    // Segment k carries syndrome bits [_segment_start(k)...) and the cover columns of
+    // the matching blocks of a single-segment code, so every segment has at least as
+    // many cover columns as syndrome bits.
+    struct _segment {
+        std::size_t first_column;
+        std::size_t columns_count;
+        std::size_t first_bit;
+        std::size_t bits_count;
+    };
+
+    _segment _make_segment(std::size_t k, std::size_t segments_count, std::size_t n, std::size_t m)
+    {
+        const std::size_t first_bit = _block_start(k, m, segments_count);
+        const std::size_t last_bit = _block_start(k + 1, m, segments_count);
+        const std::size_t first_column = _block_start(first_bit, n, m);
+        const std::size_t last_column = _block_start(last_bit, n, m);
+        return { first_column, last_column - first_column, first_bit, last_bit - first_bit };
+    }
+
+    inline std::size_t _segments_count(const stc_options& options, std::size_t m)
+    {
+        return std::min(std::max<std::size_t>(1, options.segment_count), m);
+    }
+
+    // Runs every segment with a scratch of its own, on the pool when there is one.
+    // Segments never share state so the result does not depend on the thread count.
+    template <typename function_t>
+    void _for_each_segment(
+        const stc_options& options,
+        scratch_pool& memory,
+        const std::size_t segments_count,
+        const function_t& function)
+    {
+        const auto segment = [&](const std::size_t k) {
+            const scratch_pool::lease segment_memory = memory.acquire();
+            function(k, *segment_memory);
+        };
+        if (options.pool != nullptr) {
+            // Wrapping a reference keeps std::function from allocating a copy of the lambda
+            options.pool->parallel_for(segments_count, std::cref(segment));
+            return;
+        }
+        for (std::size_t k = 0; k < segments_count; ++k) {
+            segment(k);
         }
     }
 }
@@ -31,78 +708,120 @@ double encode_stc(
     const std::uint32_t constraint_height,
     std::vector<std::uint8_t>& stego_symbols)
 {
-    (void)constraint_height; // reserved for a real trellis-based STC later
+    return encode_stc(cover_symbols, syndrome_bits, pricevector, constraint_height, stc_options {}, stego_symbols);
+}
+
+double encode_stc(
+    const std::vector<std::uint8_t>& cover_symbols,
+    const std::vector<std::uint8_t>& syndrome_bits,
+    const std::vector<std::uint8_t>& pricevector,
+    const std::uint32_t constraint_height,
+    const stc_options& options,
+    std::vector<std::uint8_t>& stego_symbols)
+{
+    bit_vector cover_packed, syndrome_packed, stego_packed;
+    pack_bits(cover_symbols, cover_packed);
+    pack_bits(syndrome_bits, syndrome_packed);
+    const double total_price = encode_stc(cover_packed, syndrome_packed, pricevector, constraint_height, options, stego_packed);
+    unpack_bits(stego_packed, stego_symbols);
+    return total_price;
+}
 
-    const std::size_t n = cover_symbols.size();
-    const std::size_t m = syndrome_bits.size();
+double encode_stc(
+    const bit_vector& cover_symbols,
+    const bit_vector& syndrome_bits,
+    const std::vector<std::uint8_t>& pricevector,
+    const std::uint32_t constraint_height,
+    bit_vector& stego_symbols)
+{
+    return encode_stc(cover_symbols, syndrome_bits, pricevector, constraint_height, stc_options {}, stego_symbols);
+}
 
-    if (pricevector.size() != n)
+double encode_stc(
+    const bit_vector& cover_symbols,
+    const bit_vector& syndrome_bits,
+    const std::vector<std::uint8_t>& pricevector,
+    const std::uint32_t constraint_height,
+    const stc_options& options,
+    bit_vector& stego_symbols)
+{
+    if (pricevector.size() != cover_symbols.size)
         throw std::runtime_error("stc_encode: pricevector size must match cover_symbols size");
 
+    return encode_stc(cover_symbols, syndrome_bits, pricevector.data(), constraint_height, options, stego_symbols);
+}
+
+double encode_stc(
+    const bit_vector& cover_symbols,
+    const bit_vector& syndrome_bits,
+    const std::uint8_t* pricevector,
+    const std::uint32_t constraint_height,
+    const stc_options& options,
+    bit_vector& stego_symbols)
+{
+    const std::size_t n = cover_symbols.size;
+    const std::size_t m = syndrome_bits.size;
+
+    if (constraint_height > _max_constraint_height)
+        throw std::runtime_error("stc_encode: constraint_height cannot exceed 15");
+
     if (m == 0) {
-        stego_symbols.assign(n, 0);
-        for (std::size_t i = 0; i < n; ++i)
-            stego_symbols[i] = _bit_from_symbol(cover_symbols[i]);
+        stego_symbols = cover_symbols;
         return 0.0;
     }
 
     if (m > n)
         throw std::runtime_error("stc_encode: payload length cannot exceed cover length in this implementation");
 
-    // Block partition: n positions -> m blocks (almost equal size)
-    const std::size_t base_block_size = n / m;
-    const std::size_t remainder = n % m; // first 'remainder' blocks get +1 element
-
-    // Start stego as copy of cover bits
-    stego_symbols.resize(n);
-    for (std::size_t i = 0; i < n; ++i)
-        stego_symbols[i] = _bit_from_symbol(cover_symbols[i]);
-
-    double total_price = 0.0;
+    scratch_pool local_memory;
+    scratch_pool& memory = options.scratch != nullptr ? *options.scratch : local_memory;
 
-    std::size_t idx = 0;
-    for (std::size_t bit_idx = 0; bit_idx < m; ++bit_idx) {
-        const std::size_t this_block_size = base_block_size + (bit_idx < remainder ? 1 : 0);
+    // Prices are 8 bits, so 256 never marks a symbol wet
+    const std::uint32_t wet = options.wet_symbols ? wet_price : 256u;
 
-        const std::size_t start = idx;
-        const std::size_t end = idx + this_block_size;
-        idx = end;
-
-        if (start >= end)
-            break; // no more room
-
-        const std::uint8_t target_bit = syndrome_bits[bit_idx] & 1u;
-
-        // Compute parity of this block
-        std::uint8_t parity = 0;
-        for (std::size_t i = start; i < end; ++i)
-            parity ^= (stego_symbols[i] & 1u);
-
-        if (parity == target_bit) {
-            // Block already encodes the bit; nothing to do.
-            continue;
+    // Segments share the words at their bounds, so each one codes into its own
+    // words and the words are merged once every segment is done. A single segment
+    // codes straight into the output.
+    const std::size_t segments_count = _segments_count(options, m);
+    const scratch_pool::lease merge_memory = memory.acquire();
+    std::uint64_t* segment_words = merge_memory->get<std::uint64_t>(_segment_words_buffer, (n + 63) / 64 + segments_count);
+    double* segment_prices = merge_memory->get<double>(_segment_prices_buffer, segments_count);
+    stego_symbols.resize(0);
+    stego_symbols.resize(n);
+    _for_each_segment(options, memory, segments_count, [&](const std::size_t k, scratch& segment_memory) {
+        const _segment segment = _make_segment(k, segments_count, n, m);
+        const std::size_t first_word = segment.first_column / 64 + k;
+        std::uint64_t* stego = segments_count == 1 ? stego_symbols.words.data() : segment_words + first_word;
+        std::fill(stego, stego + (segment.columns_count + 63) / 64, std::uint64_t(0));
+        const std::uint8_t* prices = pricevector + segment.first_column;
+
+        if (constraint_height == 0) {
+            segment_prices[k] = _encode_parity(
+                cover_symbols.words.data(), segment.first_column, segment.columns_count,
+                syndrome_bits.words.data(), segment.first_bit, segment.bits_count,
+                prices,
+                wet,
+                stego);
+        } else {
+            segment_prices[k] = _encode_trellis_table[constraint_height - 1](
+                cover_symbols.words.data(), segment.first_column, segment.columns_count,
+                syndrome_bits.words.data(), segment.first_bit, segment.bits_count,
+                prices,
+                wet,
+                options.path_memory_limit,
+                segment_memory,
+                stego);
         }
+    });
 
-        // Need to flip one symbol; pick minimal cost in this block
-        float best_cost = std::numeric_limits<float>::infinity();
-        std::size_t best_idx = end; // invalid
-
-        for (std::size_t i = start; i < end; ++i) {
-            const float c = static_cast<float>(pricevector[i]);
-            if (c < best_cost) {
-                best_cost = c;
-                best_idx = i;
-            }
+    double total_price = 0.0;
+    for (std::size_t k = 0; k < segments_count; ++k) {
+        const _segment segment = _make_segment(k, segments_count, n, m);
+        if (segments_count > 1) {
+            _copy_bits(segment_words + segment.first_column / 64 + k, 0, segment.columns_count, stego_symbols.words.data(), segment.first_column);
         }
-
-        if (best_idx == end)
-            throw std::runtime_error("stc_encode: no valid position found in block");
-
-        // Flip that bit
-        stego_symbols[best_idx] ^= 1u;
-        total_price += static_cast<double>(pricevector[best_idx]);
+        total_price += segment_prices[k];
     }
-
     return total_price;
 }
 
@@ -112,44 +831,82 @@ void decode_stc(
     const std::size_t payload_bit_count,
     std::vector<std::uint8_t>& syndrome_bits_out)
 {
-    (void)constraint_height; // reserved for future use
+    decode_stc(stego_symbols, constraint_height, payload_bit_count, stc_options {}, syndrome_bits_out);
+}
+
+void decode_stc(
+    const std::vector<std::uint8_t>& stego_symbols,
+    const std::uint32_t constraint_height,
+    const std::size_t payload_bit_count,
+    const stc_options& options,
+    std::vector<std::uint8_t>& syndrome_bits_out)
+{
+    bit_vector stego_packed, syndrome_packed;
+    pack_bits(stego_symbols, stego_packed);
+    decode_stc(stego_packed, constraint_height, payload_bit_count, options, syndrome_packed);
+    unpack_bits(syndrome_packed, syndrome_bits_out);
+}
 
-    const std::size_t n = stego_symbols.size();
+void decode_stc(
+    const bit_vector& stego_symbols,
+    const std::uint32_t constraint_height,
+    const std::size_t payload_bit_count,
+    bit_vector& syndrome_bits_out)
+{
+    decode_stc(stego_symbols, constraint_height, payload_bit_count, stc_options {}, syndrome_bits_out);
+}
+
+void decode_stc(
+    const bit_vector& stego_symbols,
+    const std::uint32_t constraint_height,
+    const std::size_t payload_bit_count,
+    const stc_options& options,
+    bit_vector& syndrome_bits_out)
+{
+    const std::size_t n = stego_symbols.size;
     const std::size_t m = payload_bit_count;
 
+    if (constraint_height > _max_constraint_height)
+        throw std::runtime_error("stc_decode: constraint_height cannot exceed 15");
+
+    if (stego_symbols.words.size() != (n + 63) / 64)
+        throw std::runtime_error("stc_decode: stego_symbols words count must match its size");
+
     if (m == 0) {
-        syndrome_bits_out.clear();
+        syndrome_bits_out.resize(0);
         return;
     }
 
     if (m > n)
         throw std::runtime_error("stc_decode: payload_bit_count cannot exceed stego length");
 
-    const std::size_t base_block_size = n / m;
-    const std::size_t remainder = n % m;
-
-    syndrome_bits_out.clear();
-    syndrome_bits_out.reserve(m);
-
-    std::size_t idx = 0;
-    for (std::size_t bit_idx = 0; bit_idx < m; ++bit_idx) {
-        const std::size_t this_block_size = base_block_size + (bit_idx < remainder ? 1 : 0);
-
-        const std::size_t start = idx;
-        const std::size_t end = idx + this_block_size;
-        idx = end;
-
-        if (start >= end) {
-            syndrome_bits_out.push_back(0);
-            continue;
+    scratch_pool local_memory;
+    scratch_pool& memory = options.scratch != nullptr ? *options.scratch : local_memory;
+
+    // Same as the encoder, segments decode into their own words before merging
+    const std::size_t segments_count = _segments_count(options, m);
+    const scratch_pool::lease merge_memory = memory.acquire();
+    std::uint64_t* segment_words = merge_memory->get<std::uint64_t>(_segment_words_buffer, (m + 63) / 64 + segments_count);
+    syndrome_bits_out.resize(0);
+    syndrome_bits_out.resize(m);
+    _for_each_segment(options, memory, segments_count, [&](const std::size_t k, scratch& segment_memory) {
+        const _segment segment = _make_segment(k, segments_count, n, m);
+        std::uint64_t* syndrome = segments_count == 1 ? syndrome_bits_out.words.data() : segment_words + segment.first_bit / 64 + k;
+        std::fill(syndrome, syndrome + (segment.bits_count + 63) / 64, std::uint64_t(0));
+
+        if (constraint_height == 0) {
+            _decode_parity(stego_symbols.words.data(), stego_symbols.words.size(), segment.first_column, segment.columns_count, segment.bits_count, syndrome);
+        } else {
+            _decode_trellis(stego_symbols.words.data(), segment.first_column, segment.columns_count, segment.bits_count, constraint_height, segment_memory, syndrome);
         }
+    });
 
-        std::uint8_t parity = 0;
-        for (std::size_t i = start; i < end; ++i)
-            parity ^= _bit_from_symbol(stego_symbols[i]);
-
-        syndrome_bits_out.push_back(parity & 1u);
+    if (segments_count > 1) {
+        for (std::size_t k = 0; k < segments_count; ++k) {
+            const _segment segment = _make_segment(k, segments_count, n, m);
+            _copy_bits(segment_words + segment.first_bit / 64 + k, 0, segment.bits_count, syndrome_bits_out.words.data(), segment.first_bit);
+        }
     }
 }
 
-}
\ No newline at end of file
+}
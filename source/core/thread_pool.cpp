@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include <binghamton/core/thread_pool.hpp>
+
+namespace binghamton {
+
+struct thread_pool::job {
+    std::size_t count;
+    const std::function<void(std::size_t)>* function;
+    std::atomic<std::size_t> next_index { 0 };
+    std::atomic<std::size_t> done_count { 0 };
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr exception;
+
+    // Claims indices until none is left, returns once this thread has no more work
+    void run()
+    {
+        for (std::size_t _index = next_index++; _index < count; _index = next_index++) {
+            try {
+                (*function)(_index);
+            } catch (...) {
+                std::lock_guard<std::mutex> _lock(mutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+            if (++done_count == count) {
+                std::lock_guard<std::mutex> _lock(mutex);
+                done.notify_all();
+            }
+        }
+    }
+};
+
+thread_pool::thread_pool(const std::size_t thread_count)
+{
+    std::size_t _thread_count = thread_count;
+    if (_thread_count == 0) {
+        _thread_count = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    _workers.reserve(_thread_count - 1);
+    for (std::size_t _index = 1; _index < _thread_count; ++_index) {
+        _workers.emplace_back([this]() { _work(); });
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+    for (std::thread& _worker : _workers) {
+        _worker.join();
+    }
+}
+
+std::size_t thread_pool::size() const
+{
+    return _workers.size() + 1;
+}
+
+void thread_pool::parallel_for(
+    const std::size_t count,
+    const std::function<void(std::size_t)>& function)
+{
+    if (count == 0) {
+        return;
+    }
+    if (_workers.empty() || count == 1) {
+        for (std::size_t _index = 0; _index < count; ++_index) {
+            function(_index);
+        }
+        return;
+    }
+
+    std::shared_ptr<job> _job = std::make_shared<job>();
+    _job->count = count;
+    _job->function = &function;
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _jobs.push_back(_job);
+    }
+    _condition.notify_all();
+
+    _job->run();
+    {
+        std::unique_lock<std::mutex> _lock(_job->mutex);
+        _job->done.wait(_lock, [&]() { return _job->done_count == count; });
+    }
+    if (_job->exception) {
+        std::rethrow_exception(_job->exception);
+    }
+}
+
+void thread_pool::_work()
+{
+    for (;;) {
+        std::shared_ptr<job> _job;
+        {
+            std::unique_lock<std::mutex> _lock(_mutex);
+            _condition.wait(_lock, [&]() { return _stopping || !_jobs.empty(); });
+            if (_stopping) {
+                return;
+            }
+            _job = _jobs.front();
+            if (_job->next_index >= _job->count) {
+                // every index is claimed, the job only waits for running ones
+                _jobs.pop_front();
+                continue;
+            }
+        }
+        _job->run();
+    }
+}
+
+}
@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 
+#include <binghamton/core/stc.hpp>
 #include <binghamton/core/ycbcr.hpp>
 
 namespace binghamton {
@@ -21,6 +24,103 @@ namespace {
         return true;
     }
 
+    // Channels of a pixel layout, a gray pixel being its own R, G and B so that its Y is itself
+    template <std::size_t channels_v, std::size_t red_v, std::size_t green_v, std::size_t blue_v>
+    struct _layout {
+        static constexpr std::size_t channels = channels_v;
+
+        static int encode_y(const std::uint8_t* pixel)
+        {
+            if constexpr (channels_v == 1) {
+                return pixel[0];
+            } else {
+                return (Y_R * pixel[red_v] + Y_G * pixel[green_v] + Y_B * pixel[blue_v]) >> 8;
+            }
+        }
+
+        static bool in_range(const std::uint8_t* pixel, const int delta)
+        {
+            return _ensure_range(pixel[red_v] + delta) && _ensure_range(pixel[green_v] + delta) && _ensure_range(pixel[blue_v] + delta);
+        }
+
+        static void add(std::uint8_t* pixel, const int delta)
+        {
+            pixel[red_v] = static_cast<std::uint8_t>(pixel[red_v] + delta);
+            if constexpr (channels_v != 1) {
+                pixel[green_v] = static_cast<std::uint8_t>(pixel[green_v] + delta);
+                pixel[blue_v] = static_cast<std::uint8_t>(pixel[blue_v] + delta);
+            }
+        }
+
+        static bool is_clipping(const std::uint8_t* pixel)
+        {
+            if constexpr (channels_v == 1) {
+                return false;
+            } else {
+                const bool _has_zero = pixel[red_v] == 0 || pixel[green_v] == 0 || pixel[blue_v] == 0;
+                const bool _has_full = pixel[red_v] == 255 || pixel[green_v] == 255 || pixel[blue_v] == 255;
+                return _has_zero && _has_full;
+            }
+        }
+    };
+
+    // Calls a function with the channels of a pixel layout, each layout compiling its own loops
+    template <typename function_t>
+    void _with_layout(const pixel_layout layout, const function_t& function)
+    {
+        switch (layout) {
+        case pixel_layout::rgb:
+            function(_layout<3, 0, 1, 2> {});
+            break;
+        case pixel_layout::bgr:
+            function(_layout<3, 2, 1, 0> {});
+            break;
+        case pixel_layout::rgba:
+            function(_layout<4, 0, 1, 2> {});
+            break;
+        case pixel_layout::bgra:
+            function(_layout<4, 2, 1, 0> {});
+            break;
+        case pixel_layout::gray:
+            function(_layout<1, 0, 0, 0> {});
+            break;
+        }
+    }
+
+    // Views packed rows as one long row, so that the kernels run without row breaks
+    image_view _flatten(image_view image)
+    {
+        if (is_packed(image)) {
+            image.width *= image.height;
+            image.height = image.height != 0 ? 1 : 0;
+            image.stride = image.width * channels_count(image.layout);
+        }
+        return image;
+    }
+
+    void _check_image(const image_view& image, const char* message)
+    {
+        if (!is_valid(image) && image.width * image.height != 0) {
+            throw std::runtime_error(message);
+        }
+    }
+
+    // Calls a function with the index of every flagged pixel, skipping the empty words
+    template <typename function_t>
+    bool _for_each_flag(const bit_vector& flags, const function_t& function)
+    {
+        for (std::size_t _word_index = 0; _word_index < flags.words.size(); ++_word_index) {
+            std::uint64_t _word = flags.words[_word_index];
+            while (_word != 0) {
+                if (!function(64 * _word_index + count_trailing_zeros(_word))) {
+                    return false;
+                }
+                _word &= _word - 1;
+            }
+        }
+        return true;
+    }
+
 }
 
 void encode_y(
@@ -31,9 +131,16 @@ void encode_y(
         throw std::runtime_error("rgb.size() must be a multiple of 3");
     }
 
-    size_t pixel_count = rgb.size() / 3;
-    y.resize(pixel_count);
-    for (size_t i = 0; i < pixel_count; ++i) {
+    y.resize(rgb.size() / 3);
+    encode_y(rgb.data(), y.size(), y.data());
+}
+
+void encode_y(
+    const std::uint8_t* rgb,
+    const std::size_t pixels_count,
+    std::uint8_t* y)
+{
+    for (size_t i = 0; i < pixels_count; ++i) {
         uint8_t r = rgb[i * 3 + 0];
         uint8_t g = rgb[i * 3 + 1];
         uint8_t b = rgb[i * 3 + 2];
@@ -80,9 +187,16 @@ bool decode_y(
         throw std::runtime_error("rgb.size() must be equal to 3 * y.size()");
     }
 
-    const std::size_t pixels_count = rgb.size() / 3;
     rgb_embedded.resize(rgb.size());
+    return decode_y(rgb.data(), y.data(), y.size(), rgb_embedded.data());
+}
 
+bool decode_y(
+    const std::uint8_t* rgb,
+    const std::uint8_t* y,
+    const std::size_t pixels_count,
+    std::uint8_t* rgb_embedded)
+{
     for (std::size_t i = 0; i < pixels_count; ++i) {
         int R0 = rgb[3 * i + 0];
         int G0 = rgb[3 * i + 1];
@@ -141,4 +255,180 @@ bool decode_y(
 //         rgb[3 * _pixel_index + 2] = _clamp(_b);
 //     }
 // }
-}
\ No newline at end of file
+
+void encode_y(
+    const image_view& image,
+    std::uint8_t* y)
+{
+    _check_image(image, "encode_y: image must have pixels and a stride of at least width * channels_count(layout)");
+    const image_view _image = _flatten(image);
+    _with_layout(_image.layout, [&](const auto layout) {
+        using layout_t = decltype(layout);
+        for (std::size_t _row = 0; _row < _image.height; ++_row) {
+            const std::uint8_t* _pixels = _image.data + _row * _image.stride;
+            std::uint8_t* _y = y + _row * _image.width;
+            for (std::size_t _column = 0; _column < _image.width; ++_column) {
+                _y[_column] = static_cast<std::uint8_t>(layout_t::encode_y(_pixels + layout_t::channels * _column));
+            }
+        }
+    });
+}
+
+void encode_y_lsb(
+    const std::uint8_t* rgb,
+    const std::size_t pixels_count,
+    bit_vector& y_lsb)
+{
+    encode_y_lsb(image_view { rgb, pixels_count, 1, 3 * pixels_count, pixel_layout::rgb }, y_lsb);
+}
+
+void encode_y_lsb(
+    const image_view& image,
+    bit_vector& y_lsb)
+{
+    _check_image(image, "encode_y_lsb: image must have pixels and a stride of at least width * channels_count(layout)");
+    const image_view _image = _flatten(image);
+    const std::size_t _pixels_count = image.width * image.height;
+    y_lsb.words.resize((_pixels_count + 63) / 64);
+    y_lsb.size = _pixels_count;
+    std::fill(y_lsb.words.begin(), y_lsb.words.end(), 0);
+
+    // Y of up to 64 pixels of a row in 16-bit fixed point, a loop the compiler vectorizes,
+    // then packed into the word holding them
+    _with_layout(_image.layout, [&](const auto layout) {
+        using layout_t = decltype(layout);
+        for (std::size_t _row = 0; _row < _image.height; ++_row) {
+            const std::uint8_t* _pixels = _image.data + _row * _image.stride;
+            std::size_t _column = 0;
+            while (_column < _image.width) {
+                const std::size_t _pixel_index = _row * _image.width + _column;
+                const std::size_t _first_bit = _pixel_index % 64;
+                const std::size_t _count = std::min(64 - _first_bit, _image.width - _column);
+                std::uint8_t _lsb[64] = {};
+                for (std::size_t _index = 0; _index < _count; ++_index) {
+                    _lsb[_index] = static_cast<std::uint8_t>(layout_t::encode_y(_pixels + layout_t::channels * (_column + _index)) & 1);
+                }
+                // Eight 0 or 1 bytes gather into one byte with a multiplication
+                std::uint64_t _word = 0;
+                for (std::size_t _byte_index = 0; _byte_index < 8; ++_byte_index) {
+                    std::uint64_t _bytes;
+                    std::memcpy(&_bytes, _lsb + 8 * _byte_index, 8);
+                    _word |= ((_bytes * 0x0102040810204080ULL) >> 56) << (8 * _byte_index);
+                }
+                y_lsb.words[_pixel_index / 64] |= _word << _first_bit;
+                _column += _count;
+            }
+        }
+    });
+}
+
+bool decode_y_lsb(
+    const std::uint8_t* rgb,
+    const bit_vector& y_lsb_flips,
+    std::uint8_t* rgb_embedded)
+{
+    const std::size_t _pixels_count = y_lsb_flips.size;
+    return decode_y_lsb(
+        image_view { rgb, _pixels_count, 1, 3 * _pixels_count, pixel_layout::rgb },
+        y_lsb_flips,
+        mutable_image_view { rgb_embedded, _pixels_count, 1, 3 * _pixels_count, pixel_layout::rgb });
+}
+
+bool decode_y_lsb(
+    const image_view& image,
+    const bit_vector& y_lsb_flips,
+    const mutable_image_view& image_embedded)
+{
+    _check_image(image, "decode_y_lsb: image must have pixels and a stride of at least width * channels_count(layout)");
+    _check_image(image_embedded, "decode_y_lsb: image_embedded must have pixels and a stride of at least width * channels_count(layout)");
+    if (image_embedded.width != image.width || image_embedded.height != image.height || image_embedded.layout != image.layout) {
+        throw std::runtime_error("decode_y_lsb: image_embedded must have the size and the layout of image");
+    }
+    if (y_lsb_flips.size != image.width * image.height) {
+        throw std::runtime_error("decode_y_lsb: y_lsb_flips.size must be equal to width * height");
+    }
+
+    const std::size_t _row_bytes = image.width * channels_count(image.layout);
+    if (image_embedded.data != image.data) {
+        for (std::size_t _row = 0; _row < image.height; ++_row) {
+            std::memcpy(image_embedded.data + _row * image_embedded.stride, image.data + _row * image.stride, _row_bytes);
+        }
+    }
+
+    bool _in_range = true;
+    _with_layout(image.layout, [&](const auto layout) {
+        using layout_t = decltype(layout);
+        const auto _pixel = [&](const std::size_t pixel_index) {
+            return image_embedded.data + (pixel_index / image.width) * image_embedded.stride + layout_t::channels * (pixel_index % image.width);
+        };
+
+        // Every flip is checked before the first one is applied, so that a failure leaves the
+        // original pixels even in place. Y moves by exactly the delta of R, G and B, the weights
+        // summing to 256, so both directions flip the LSB.
+        const auto _delta = [&](const std::uint8_t* pixel) {
+            const int _preferred = (layout_t::encode_y(pixel) & 1) != 0 ? -1 : 1;
+            return layout_t::in_range(pixel, _preferred) ? _preferred : -_preferred;
+        };
+        _in_range = _for_each_flag(y_lsb_flips, [&](const std::size_t pixel_index) {
+            const std::uint8_t* _flipped = _pixel(pixel_index);
+            return layout_t::in_range(_flipped, _delta(_flipped));
+        });
+        if (_in_range) {
+            _for_each_flag(y_lsb_flips, [&](const std::size_t pixel_index) {
+                std::uint8_t* _flipped = _pixel(pixel_index);
+                layout_t::add(_flipped, _delta(_flipped));
+                return true;
+            });
+        }
+    });
+    return _in_range;
+}
+
+void wet_y_clipping(
+    const std::uint8_t* rgb,
+    const std::size_t pixels_count,
+    std::uint8_t* price)
+{
+    wet_y_clipping(image_view { rgb, pixels_count, 1, 3 * pixels_count, pixel_layout::rgb }, price);
+}
+
+void wet_y_clipping(
+    const image_view& image,
+    std::uint8_t* price)
+{
+    _check_image(image, "wet_y_clipping: image must have pixels and a stride of at least width * channels_count(layout)");
+    const image_view _image = _flatten(image);
+    _with_layout(_image.layout, [&](const auto layout) {
+        using layout_t = decltype(layout);
+        for (std::size_t _row = 0; _row < _image.height; ++_row) {
+            const std::uint8_t* _pixels = _image.data + _row * _image.stride;
+            std::uint8_t* _price = price + _row * _image.width;
+            for (std::size_t _column = 0; _column < _image.width; ++_column) {
+                _price[_column] = layout_t::is_clipping(_pixels + layout_t::channels * _column) ? wet_price : _price[_column];
+            }
+        }
+    });
+}
+
+std::size_t find_unclipped_pixels(
+    const image_view& image,
+    const std::size_t count,
+    std::size_t* indices)
+{
+    _check_image(image, "find_unclipped_pixels: image must have pixels and a stride of at least width * channels_count(layout)");
+    std::size_t _found = 0;
+    _with_layout(image.layout, [&](const auto layout) {
+        using layout_t = decltype(layout);
+        for (std::size_t _row = 0; _row < image.height && _found < count; ++_row) {
+            const std::uint8_t* _pixels = image.data + _row * image.stride;
+            for (std::size_t _column = 0; _column < image.width && _found < count; ++_column) {
+                if (!layout_t::is_clipping(_pixels + layout_t::channels * _column)) {
+                    indices[_found++] = _row * image.width + _column;
+                }
+            }
+        }
+    });
+    return _found;
+}
+
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/core/ycbcr.hpp>
+#include <binghamton/method/band.hpp>
+
+namespace binghamton {
+namespace {
+
+    // Buffers of the band scratch of the workspace
+    enum _band_buffer : std::size_t {
+        _window_buffer,
+        _stego_buffer,
+        _y_buffer,
+        _rho_buffer,
+        _price_buffer
+    };
+
+    // Rows of the bands, the last band taking the rows left by the others so that no band is
+    // too small to carry its header
+    struct _band_layout {
+        std::size_t height = 0;
+        std::size_t band_height = 0;
+        std::size_t bands_count = 0;
+
+        std::size_t first_row(const std::size_t index) const
+        {
+            return index * band_height;
+        }
+
+        std::size_t rows_count(const std::size_t index) const
+        {
+            return index + 1 == bands_count ? height - first_row(index) : band_height;
+        }
+    };
+
+    _band_layout _make_band_layout(const std::size_t width, const std::size_t height, const band_options& bands, const char* message)
+    {
+        if (width == 0 || height == 0 || bands.band_height == 0) {
+            throw std::runtime_error(message);
+        }
+        _band_layout layout;
+        layout.height = height;
+        layout.band_height = std::min(bands.band_height, height);
+        layout.bands_count = height / layout.band_height;
+        return layout;
+    }
+
+} // namespace
+
+band_embedder::band_embedder(
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const band_options& bands,
+    const embed_options& options,
+    workspace& memory,
+    const band_reader& read,
+    const band_writer& write)
+    : _width(width)
+    , _height(height)
+    , _steg_key(steg_key)
+    , _constraint_height(constraint_height)
+    , _payload_bits(payload_bits)
+    , _bands(bands)
+    , _embed(options)
+    , _memory(memory)
+    , _read(read)
+    , _write(write)
+    , _timer(options.stats)
+{
+    const _band_layout layout = _make_band_layout(width, height, bands, "embed_bands: width, height and band_height cannot be 0");
+    _height_per_band = layout.band_height;
+    _bands_count = layout.bands_count;
+    _row_bytes = width * channels_count(bands.layout);
+    const std::size_t max_rows_count = layout.rows_count(layout.bands_count - 1);
+    const std::size_t max_window_rows_count = std::min(height, max_rows_count + 2 * bands.halo_rows);
+    const std::size_t bands_capacity = memory.bands.capacity();
+
+    _window = memory.bands.get<std::uint8_t>(_window_buffer, max_window_rows_count * _row_bytes);
+    _stego = memory.bands.get<std::uint8_t>(_stego_buffer, max_rows_count * _row_bytes);
+    _y = memory.bands.get<std::uint8_t>(_y_buffer, max_window_rows_count * width);
+    _rho = memory.bands.get<float>(_rho_buffer, max_window_rows_count * width);
+    _price = memory.bands.get<std::uint8_t>(_price_buffer, max_rows_count * width);
+    if (options.stats != nullptr) {
+        options.stats->allocated_bytes += memory.bands.capacity() - bands_capacity;
+    }
+
+    if (_embed.permutations == nullptr) {
+        _embed.permutations = &_permutations;
+    }
+    _costs.pool = options.pool;
+    _costs.scratch = &memory.tasks;
+}
+
+bool band_embedder::next_band()
+{
+    if (_band_index == _bands_count) {
+        return false;
+    }
+
+    // The window holds the cover rows [window_first, window_last) of the band and its halo,
+    // the rows shared with the previous window being moved rather than read again
+    const _band_layout layout = { _height, _height_per_band, _bands_count };
+    _first_row = layout.first_row(_band_index);
+    _rows_count = layout.rows_count(_band_index);
+    const std::size_t first = _first_row - std::min(_first_row, _bands.halo_rows);
+    const std::size_t last = std::min(_height, _first_row + _rows_count + _bands.halo_rows);
+    if (first > _window_first) {
+        std::memmove(_window, _window + (first - _window_first) * _row_bytes, (_window_last - first) * _row_bytes);
+    }
+    _window_first = first;
+    if (last > _window_last) {
+        _read(_window_last, mutable_image_view { _window + (_window_last - first) * _row_bytes, _width, last - _window_last, _row_bytes, _bands.layout });
+        _window_last = last;
+    }
+
+    // The band is priced within its window, so that its costs see the pixels of its halo
+    _timer = embed_timer(_embed.stats);
+    encode_y(image_view { _window, _width, _window_last - _window_first, _row_bytes, _bands.layout }, _y);
+    _timer.lap(embed_stage::encode_y);
+    return true;
+}
+
+const std::uint8_t* band_embedder::window_y() const
+{
+    return _y;
+}
+
+float* band_embedder::window_rho() const
+{
+    return _rho;
+}
+
+std::size_t band_embedder::window_rows_count() const
+{
+    return _window_last - _window_first;
+}
+
+const cost_options& band_embedder::costs() const
+{
+    return _costs;
+}
+
+void band_embedder::embed_band()
+{
+    const std::size_t band_offset = _first_row - _window_first;
+    quantize_costs(_rho + band_offset * _width, _rows_count * _width, _costs, _price);
+    const image_view band { _window + band_offset * _row_bytes, _width, _rows_count, _row_bytes, _bands.layout };
+    wet_y_clipping(band, _price);
+    _timer.lap(embed_stage::cost);
+
+    // Each band carries the payload bits of its share of the pixels
+    const std::size_t first_bit = _payload_bits.size * _first_row / _height;
+    const std::size_t last_bit = _payload_bits.size * (_first_row + _rows_count) / _height;
+    _band_bits.resize(last_bit - first_bit);
+    for (std::size_t bit = first_bit; bit < last_bit; ++bit) {
+        _band_bits.set(bit - first_bit, _payload_bits.get(bit));
+    }
+
+    double band_cost = 0.0;
+    const mutable_image_view band_embedded { _stego, _width, _rows_count, _row_bytes, _bands.layout };
+    _embedded = embed_priced_luminance(band, _steg_key, _constraint_height, _band_bits, _y + band_offset * _width, _price, _embed, _memory, band_embedded, band_cost) && _embedded;
+    _cost_embedded += band_cost;
+    _write(_first_row, band_embedded);
+    ++_band_index;
+}
+
+bool band_embedder::embedded() const
+{
+    return _embedded;
+}
+
+double band_embedder::cost_embedded() const
+{
+    return _cost_embedded;
+}
+
+void extract_bands(
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const band_options& bands,
+    const extract_options& options,
+    workspace& memory,
+    const band_reader& read,
+    bit_vector& payload_bits_out)
+{
+    const _band_layout layout = _make_band_layout(width, height, bands, "extract_bands: width, height and band_height cannot be 0");
+    const std::size_t row_bytes = width * channels_count(bands.layout);
+    std::uint8_t* rows = memory.bands.get<std::uint8_t>(_window_buffer, layout.rows_count(layout.bands_count - 1) * row_bytes);
+
+    permutation_cache band_permutations;
+    extract_options extract = options;
+    if (extract.permutations == nullptr) {
+        extract.permutations = &band_permutations;
+    }
+
+    bit_vector band_bits;
+    payload_bits_out.resize(0);
+    for (std::size_t index = 0; index < layout.bands_count; ++index) {
+        const std::size_t first_row = layout.first_row(index);
+        const std::size_t rows_count = layout.rows_count(index);
+        const mutable_image_view band { rows, width, rows_count, row_bytes, bands.layout };
+        read(first_row, band);
+        extract_luminance(band, steg_key, constraint_height, std::min(max_payload_bit_count, rows_count * width), extract, memory, band_bits);
+        if (payload_bits_out.size + band_bits.size > max_payload_bit_count) {
+            throw std::runtime_error("extract_bands: payload length exceeds max_payload_bit_count");
+        }
+
+        const std::size_t first_bit = payload_bits_out.size;
+        payload_bits_out.resize(first_bit + band_bits.size);
+        for (std::size_t bit = 0; bit < band_bits.size; ++bit) {
+            payload_bits_out.set(first_bit + bit, band_bits.get(bit));
+        }
+    }
+}
+
+}
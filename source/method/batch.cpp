@@ -0,0 +1,67 @@
+#include <stdexcept>
+
+#include <binghamton/method/batch.hpp>
+
+namespace binghamton {
+
+void run_batch(
+    const std::size_t count,
+    const batch_options& options,
+    const std::function<void(std::size_t)>& job,
+    const std::function<void(std::size_t, const std::string&)>& errors)
+{
+    // Each job records its own error, so that the pool never sees an exception and keeps
+    // running the other jobs
+    const std::function<void(std::size_t)> guarded_job = [&](const std::size_t index) {
+        try {
+            job(index);
+        } catch (const std::exception& exception) {
+            errors(index, exception.what());
+        } catch (...) {
+            errors(index, "unknown exception");
+        }
+    };
+
+    if (options.pool != nullptr) {
+        options.pool->parallel_for(count, guarded_job);
+    } else {
+        for (std::size_t index = 0; index < count; ++index) {
+            guarded_job(index);
+        }
+    }
+}
+
+void extract_batch(
+    const std::vector<extract_job>& jobs,
+    const std::uint32_t constraint_height,
+    const batch_options& options,
+    std::vector<extract_result>& results)
+{
+    results.clear();
+    results.resize(jobs.size());
+
+    permutation_cache batch_permutations(options.permutations_byte_limit);
+    extract_options extract;
+    extract.permutations = options.permutations != nullptr ? options.permutations : &batch_permutations;
+    workspace_pool batch_workspaces;
+    workspace_pool& workspaces = options.workspaces != nullptr ? *options.workspaces : batch_workspaces;
+
+    run_batch(
+        jobs.size(), options,
+        [&](const std::size_t index) {
+            const extract_job& job = jobs[index];
+            if (job.rgb_stego == nullptr) {
+                throw std::runtime_error("extract_batch: rgb_stego cannot be null");
+            }
+            if (job.rgb_stego->size() != 3 * job.width * job.height) {
+                throw std::runtime_error("extract_batch: rgb_stego.size() must be equal to 3 * width * height");
+            }
+            workspace_pool::lease memory = workspaces.acquire();
+            extract_luminance(make_image_view(*job.rgb_stego, job.width, job.height), job.steg_key, constraint_height, job.max_payload_bit_count, extract, *memory, results[index].payload_bits);
+        },
+        [&](const std::size_t index, const std::string& error) {
+            results[index].error = error;
+        });
+}
+
+}
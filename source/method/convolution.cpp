@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include <binghamton/core/bits.hpp>
+#include <binghamton/method/convolution.hpp>
+
+namespace binghamton {
+namespace {
+
+    constexpr double _pi = 3.14159265358979323846;
+
+    // Kernels of at least this many taps are correlated through the fft, measured
+    // as the crossover point of the convolution benchmark.
+    constexpr std::size_t _fft_min_taps = 160;
+
+    inline bool _use_fft(const std::size_t taps_count, const convolution_method method)
+    {
+        return method == convolution_method::fft
+            || (method == convolution_method::automatic && taps_count >= _fft_min_taps);
+    }
+
+    inline void _multiply_accumulate(
+        const float* BINGHAMTON_RESTRICT source,
+        const float tap,
+        float* BINGHAMTON_RESTRICT destination,
+        const std::size_t count)
+    {
+        for (std::size_t x = 0; x < count; ++x) {
+            destination[x] += tap * source[x];
+        }
+    }
+
+    constexpr std::size_t _block_width = 16;
+
+    // Correlates count outputs of a column pass, the samples of tap t starting on row
+    // t. Outputs are accumulated a block at a time in registers over every tap, which
+    // vectorizes the block and writes each output once.
+    void _correlate_columns_direct(
+        const float* BINGHAMTON_RESTRICT source,
+        const std::size_t tap_step,
+        const std::vector<float>& taps,
+        float* BINGHAMTON_RESTRICT destination,
+        const std::size_t count)
+    {
+        const std::size_t taps_count = taps.size();
+        std::size_t x = 0;
+        for (; x + _block_width <= count; x += _block_width) {
+            float sums[_block_width] = {};
+            for (std::size_t t = 0; t < taps_count; ++t) {
+                const float tap = taps[t];
+                const float* samples = source + t * tap_step + x;
+                for (std::size_t k = 0; k < _block_width; ++k) {
+                    sums[k] += tap * samples[k];
+                }
+            }
+            for (std::size_t k = 0; k < _block_width; ++k) {
+                destination[x + k] = sums[k];
+            }
+        }
+        for (; x < count; ++x) {
+            float sum = 0.0f;
+            for (std::size_t t = 0; t < taps_count; ++t) {
+                sum += taps[t] * source[t * tap_step + x];
+            }
+            destination[x] = sum;
+        }
+    }
+
+    // Complex product spelled out, std::complex calls into the inf and nan handling of C99 Annex G.
+    inline std::complex<double> _multiply(const std::complex<double> a, const std::complex<double> b)
+    {
+        return { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+    }
+
+    // In-place iterative radix-2 fft, the inverse transform is left unscaled.
+    void _fft(
+        std::complex<double>* data,
+        const std::size_t count,
+        const std::vector<std::size_t>& reversed_indices,
+        const std::vector<std::complex<double>>& twiddles,
+        const bool inverse)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i < reversed_indices[i]) {
+                std::swap(data[i], data[reversed_indices[i]]);
+            }
+        }
+        for (std::size_t length = 2; length <= count; length <<= 1) {
+            const std::size_t half = length / 2;
+            const std::size_t step = count / length;
+            for (std::size_t first = 0; first < count; first += length) {
+                for (std::size_t k = 0; k < half; ++k) {
+                    const std::complex<double> twiddle = inverse ? std::conj(twiddles[k * step]) : twiddles[k * step];
+                    const std::complex<double> even = data[first + k];
+                    const std::complex<double> odd = _multiply(data[first + k + half], twiddle);
+                    data[first + k] = even + odd;
+                    data[first + k + half] = even - odd;
+                }
+            }
+        }
+    }
+
+    // Correlates lines of samples laid out with any element and line steps, which
+    // covers both rows and columns. Two real lines are packed in the real and
+    // imaginary parts of one complex transform, the kernel being real their
+    // correlations come back in the real and imaginary parts of the result.
+    void _correlate_lines_fft(
+        const float* input,
+        const std::size_t input_element_step,
+        const std::size_t input_line_step,
+        const std::size_t lines_count,
+        const std::size_t output_length,
+        const std::vector<float>& taps,
+        float* output,
+        const std::size_t output_element_step,
+        const std::size_t output_line_step)
+    {
+        const std::size_t input_length = output_length + taps.size() - 1;
+        std::size_t count = 1;
+        while (count < input_length) {
+            count <<= 1;
+        }
+
+        std::vector<std::size_t> reversed_indices(count, 0);
+        for (std::size_t i = 1; i < count; ++i) {
+            reversed_indices[i] = (reversed_indices[i >> 1] >> 1) | ((i & 1) ? count >> 1 : 0);
+        }
+        std::vector<std::complex<double>> twiddles(count / 2);
+        for (std::size_t k = 0; k < count / 2; ++k) {
+            twiddles[k] = std::polar(1.0, -2.0 * _pi * static_cast<double>(k) / static_cast<double>(count));
+        }
+
+        // Correlating with taps is multiplying by the conjugate of their spectrum
+        std::vector<std::complex<double>> spectrum(count);
+        for (std::size_t t = 0; t < taps.size(); ++t) {
+            spectrum[t] = taps[t];
+        }
+        _fft(spectrum.data(), count, reversed_indices, twiddles, false);
+        const double scale = 1.0 / static_cast<double>(count);
+        for (std::complex<double>& value : spectrum) {
+            value = std::conj(value) * scale;
+        }
+
+        std::vector<std::complex<double>> buffer(count);
+        for (std::size_t line = 0; line < lines_count; line += 2) {
+            const bool pair = line + 1 < lines_count;
+            const float* first_line = input + line * input_line_step;
+            const float* second_line = first_line + input_line_step;
+            for (std::size_t x = 0; x < input_length; ++x) {
+                const float second = pair ? second_line[x * input_element_step] : 0.0f;
+                buffer[x] = std::complex<double>(first_line[x * input_element_step], second);
+            }
+            std::fill(buffer.begin() + input_length, buffer.end(), std::complex<double>());
+
+            _fft(buffer.data(), count, reversed_indices, twiddles, false);
+            for (std::size_t k = 0; k < count; ++k) {
+                buffer[k] = _multiply(buffer[k], spectrum[k]);
+            }
+            _fft(buffer.data(), count, reversed_indices, twiddles, true);
+
+            float* first_output = output + line * output_line_step;
+            float* second_output = first_output + output_line_step;
+            for (std::size_t x = 0; x < output_length; ++x) {
+                first_output[x * output_element_step] = static_cast<float>(buffer[x].real());
+                if (pair) {
+                    second_output[x * output_element_step] = static_cast<float>(buffer[x].imag());
+                }
+            }
+        }
+    }
+
+}
+
+void correlate_rows(
+    const float* input,
+    const std::size_t input_stride,
+    const std::size_t output_width,
+    const std::size_t height,
+    const std::vector<float>& taps,
+    float* output,
+    const std::size_t output_stride,
+    const convolution_method method)
+{
+    if (taps.empty()) {
+        throw std::runtime_error("correlate_rows: taps cannot be empty");
+    }
+    if (output_width == 0 || height == 0) {
+        return;
+    }
+
+    if (_use_fft(taps.size(), method)) {
+        _correlate_lines_fft(input, 1, input_stride, height, output_width, taps, output, 1, output_stride);
+        return;
+    }
+
+    // Tap by tap over the whole row keeps the inner loop a contiguous multiply-add on a
+    // row that stays in cache
+    for (std::size_t y = 0; y < height; ++y) {
+        const float* input_row = input + y * input_stride;
+        float* output_row = output + y * output_stride;
+        std::fill(output_row, output_row + output_width, 0.0f);
+        for (std::size_t t = 0; t < taps.size(); ++t) {
+            _multiply_accumulate(input_row + t, taps[t], output_row, output_width);
+        }
+    }
+}
+
+void correlate_columns(
+    const float* input,
+    const std::size_t input_stride,
+    const std::size_t width,
+    const std::size_t output_height,
+    const std::vector<float>& taps,
+    float* output,
+    const std::size_t output_stride,
+    const convolution_method method)
+{
+    if (taps.empty()) {
+        throw std::runtime_error("correlate_columns: taps cannot be empty");
+    }
+    if (width == 0 || output_height == 0) {
+        return;
+    }
+
+    if (_use_fft(taps.size(), method)) {
+        _correlate_lines_fft(input, input_stride, 1, width, output_height, taps, output, output_stride, 1);
+        return;
+    }
+
+    // Taps step over input rows, so every access along a block stays contiguous
+    for (std::size_t y = 0; y < output_height; ++y) {
+        _correlate_columns_direct(input + y * input_stride, input_stride, taps, output + y * output_stride, width);
+    }
+}
+
+}
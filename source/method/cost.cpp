@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include <binghamton/method/cost.hpp>
+
+namespace binghamton {
+namespace {
+
+    // Costs per chunk of the quantization.
+    constexpr std::size_t _chunk_size = 1 << 16;
+
+    // Groups of chunks reducing their minimum in parallel, enough to keep every thread busy.
+    constexpr std::size_t _groups_count = 64;
+
+    // Price of the cheapest pixel, prices grow linearly with the cost from there.
+    constexpr float _price_per_min_cost = 8.0f;
+
+    inline std::uint8_t _clamp_price(float v)
+    {
+        if (v < 1.0f)
+            v = 1.0f;
+        if (v > 254.0f)
+            v = 254.0f;
+        // v is positive, truncating v + 0.5 rounds like lround without the libm call
+        return static_cast<std::uint8_t>(v + 0.5f);
+    }
+
+    template <typename function_t>
+    void _run(
+        const std::size_t count,
+        const cost_options& options,
+        const function_t& function)
+    {
+        if (options.pool != nullptr) {
+            options.pool->parallel_for(count, std::cref(function));
+        } else {
+            for (std::size_t index = 0; index < count; ++index) {
+                function(index);
+            }
+        }
+    }
+
+} // namespace
+
+void quantize_costs(
+    const std::vector<float>& rho,
+    std::vector<std::uint8_t>& price)
+{
+    quantize_costs(rho, cost_options {}, price);
+}
+
+void quantize_costs(
+    const std::vector<float>& rho,
+    const cost_options& options,
+    std::vector<std::uint8_t>& price)
+{
+    price.resize(rho.size());
+    quantize_costs(rho.data(), rho.size(), options, price.data());
+}
+
+void quantize_costs(
+    const float* rho,
+    const std::size_t count,
+    const cost_options& options,
+    std::uint8_t* price)
+{
+    // Costs are normalized by the cheapest dry pixel, dry prices stop below the wet price. The
+    // minimum of every group of chunks is reduced afterwards, min being exact the order
+    // does not matter.
+    const std::size_t chunks_count = (count + _chunk_size - 1) / _chunk_size;
+    const std::size_t group_size = (chunks_count + _groups_count - 1) / _groups_count * _chunk_size;
+    std::array<float, _groups_count> group_min_rho;
+    group_min_rho.fill(wet_cost);
+    _run(std::min(_groups_count, chunks_count), options, [&](const std::size_t group) {
+        const std::size_t last = std::min(count, (group + 1) * group_size);
+        float min_rho = wet_cost;
+        for (std::size_t i = group * group_size; i < last; ++i) {
+            min_rho = std::min(min_rho, rho[i]);
+        }
+        group_min_rho[group] = min_rho;
+    });
+    float min_rho = wet_cost;
+    for (const float value : group_min_rho) {
+        min_rho = std::min(min_rho, value);
+    }
+    const float scale = _price_per_min_cost / min_rho;
+
+    _run(chunks_count, options, [&](const std::size_t chunk) {
+        const std::size_t last = std::min(count, (chunk + 1) * _chunk_size);
+        for (std::size_t i = chunk * _chunk_size; i < last; ++i) {
+            price[i] = rho[i] < wet_cost ? _clamp_price(rho[i] * scale) : wet_price;
+        }
+    });
+}
+
+}
@@ -0,0 +1,399 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include <binghamton/method/convolution.hpp>
+#include <binghamton/method/hill.hpp>
+#include <binghamton/method/pipeline.hpp>
+
+namespace binghamton {
+namespace {
+
+    // Radius of the box filter spreading the residual, 3x3 in the reference implementation
+    constexpr std::size_t _residual_radius = 1;
+
+    // Radius of the box filter spreading the costs, 15x15 in the reference implementation
+    constexpr std::size_t _cost_radius = 7;
+
+    // Buffers of the scratch of one tile
+    enum _tile_buffer : std::size_t {
+        _kernel_columns_buffer,
+        _residual_columns_buffer,
+        _cost_columns_buffer,
+        _residual_rows_buffer,
+        _residual_prefix_buffer,
+        _vertical_buffer,
+        _residual_buffer,
+        _cost_rows_buffer,
+        _wet_rows_buffer,
+        _cost_prefix_buffer,
+        _finite_costs_buffer,
+        _wet_prefix_buffer,
+        _residual_sums_buffer,
+        _wet_buffer,
+        _cost_window_buffer,
+        _wet_window_buffer
+    };
+
+    // Sums every 2 * radius + 1 samples window of a row with symmetric padding, as the
+    // differences of the 1-D integral image of the padded row.
+    template <typename sum_t, typename value_t>
+    void _horizontal_box_sums(
+        const value_t* row,
+        const std::size_t* padded_columns,
+        const std::size_t width,
+        const std::size_t radius,
+        sum_t* prefix,
+        sum_t* sums)
+    {
+        const std::size_t span = 2 * radius + 1;
+        prefix[0] = sum_t(0);
+        for (std::size_t x = 0; x < width + 2 * radius; ++x) {
+            prefix[x + 1] = prefix[x] + static_cast<sum_t>(row[padded_columns[x]]);
+        }
+        for (std::size_t x = 0; x < width; ++x) {
+            sums[x] = prefix[x + span] - prefix[x];
+        }
+    }
+
+    // Slots of the last rows computed by a stage. The rows read by a vertical box filter
+    // always form a range of at most span consecutive rows, even when the symmetric padding
+    // reflects more than once, so that row % span never evicts a row still in use.
+    template <std::size_t span>
+    struct _row_ring {
+
+        _row_ring()
+        {
+            tags.fill(static_cast<std::size_t>(-1));
+        }
+
+        // Returns the slot of a row, missing tells if the row must be computed into it
+        std::size_t slot(const std::size_t row, bool& missing)
+        {
+            const std::size_t index = row % span;
+            missing = tags[index] != row;
+            tags[index] = row;
+            return index;
+        }
+
+        std::array<std::size_t, span> tags;
+    };
+
+    const std::size_t* _padded_columns(scratch& memory, const std::size_t buffer, const std::size_t width, const std::size_t radius)
+    {
+        std::size_t* padded_columns = memory.get<std::size_t>(buffer, width + 2 * radius);
+        for (std::size_t x = 0; x < width + 2 * radius; ++x) {
+            padded_columns[x] = symmetric_index(static_cast<std::ptrdiff_t>(x) - static_cast<std::ptrdiff_t>(radius), width);
+        }
+        return padded_columns;
+    }
+
+    // Costs of the rows [first_row, first_row + rows_count). The three stages are streamed
+    // row by row, each one keeping in a ring only the horizontal box sums of the rows its
+    // vertical box filter reads. No intermediate plane is needed, which on large images
+    // costs more than the filters themselves. The running window starts over on every
+    // tile, so that the rounding of a tile never depends on the tiles before it.
+    void _cost_hill_rows(
+        const std::uint8_t* Y,
+        const std::size_t width,
+        const std::size_t height,
+        const std::size_t first_row,
+        const std::size_t rows_count,
+        scratch& memory,
+        float* rho)
+    {
+        constexpr std::size_t residual_span = 2 * _residual_radius + 1;
+        constexpr std::size_t cost_span = 2 * _cost_radius + 1;
+        const double residual_area = static_cast<double>(residual_span * residual_span);
+        const double cost_area = static_cast<double>(cost_span * cost_span);
+        const std::size_t* kernel_columns = _padded_columns(memory, _kernel_columns_buffer, width, 1);
+        const std::size_t* residual_columns = _padded_columns(memory, _residual_columns_buffer, width, _residual_radius);
+        const std::size_t* cost_columns = _padded_columns(memory, _cost_columns_buffer, width, _cost_radius);
+        const auto row_at = [](const std::ptrdiff_t y, const std::size_t count) {
+            return symmetric_index(y, count);
+        };
+
+        // 1. Residual R = imfilter(Y, KB, 'symmetric') with the Ker-Böhme kernel
+        // KB = [-1 2 -1; 2 -4 2; -1 2 -1], the outer product of [1 -2 1] with its
+        // opposite, exact in integers and at most 16 * 255 in absolute value. Rows of
+        // |R| are kept as their horizontal 3-sums.
+        _row_ring<residual_span> residual_ring;
+        std::uint32_t* residual_rows = memory.get<std::uint32_t>(_residual_rows_buffer, residual_span * width);
+        std::uint32_t* residual_prefix = memory.get<std::uint32_t>(_residual_prefix_buffer, width + 2 * _residual_radius + 1);
+        std::int32_t* vertical = memory.get<std::int32_t>(_vertical_buffer, width + 2);
+        std::uint16_t* residual = memory.get<std::uint16_t>(_residual_buffer, width);
+        const auto residual_row = [&](const std::size_t y) {
+            bool missing;
+            std::uint32_t* sums = residual_rows + residual_ring.slot(y, missing) * width;
+            if (missing) {
+                const std::uint8_t* above = Y + row_at(static_cast<std::ptrdiff_t>(y) - 1, height) * width;
+                const std::uint8_t* center = Y + y * width;
+                const std::uint8_t* below = Y + row_at(static_cast<std::ptrdiff_t>(y) + 1, height) * width;
+                for (std::size_t x = 0; x < width + 2; ++x) {
+                    const std::size_t column = kernel_columns[x];
+                    vertical[x] = static_cast<std::int32_t>(above[column]) - 2 * static_cast<std::int32_t>(center[column]) + static_cast<std::int32_t>(below[column]);
+                }
+                for (std::size_t x = 0; x < width; ++x) {
+                    residual[x] = static_cast<std::uint16_t>(std::abs(vertical[x] - 2 * vertical[x + 1] + vertical[x + 2]));
+                }
+                _horizontal_box_sums(residual, residual_columns, width, _residual_radius, residual_prefix, sums);
+            }
+            return sums;
+        };
+
+        // 2. W1 = imfilter(|R|, average 3x3, 'symmetric') and rho = 1 / (W1 + 1e-10), a
+        // null W1 leaves the pixel wet. Sums of integers are exact. Wet pixels are counted
+        // apart from the finite costs, so that their 1e10 never cancels the finite sums.
+        // Rows are kept as their horizontal 15-sums.
+        _row_ring<cost_span> cost_ring;
+        double* cost_rows = memory.get<double>(_cost_rows_buffer, cost_span * width);
+        std::uint32_t* wet_rows = memory.get<std::uint32_t>(_wet_rows_buffer, cost_span * width);
+        double* cost_prefix = memory.get<double>(_cost_prefix_buffer, width + 2 * _cost_radius + 1);
+        double* finite_costs = memory.get<double>(_finite_costs_buffer, width);
+        std::uint32_t* wet_prefix = memory.get<std::uint32_t>(_wet_prefix_buffer, width + 2 * _cost_radius + 1);
+        std::uint32_t* residual_sums = memory.get<std::uint32_t>(_residual_sums_buffer, width);
+        std::uint8_t* wet = memory.get<std::uint8_t>(_wet_buffer, width);
+        const auto cost_row = [&](const std::size_t y) {
+            bool missing;
+            const std::size_t slot = cost_ring.slot(y, missing);
+            if (missing) {
+                std::fill(residual_sums, residual_sums + width, 0u);
+                for (std::ptrdiff_t k = -static_cast<std::ptrdiff_t>(_residual_radius); k <= static_cast<std::ptrdiff_t>(_residual_radius); ++k) {
+                    const std::uint32_t* sums = residual_row(row_at(static_cast<std::ptrdiff_t>(y) + k, height));
+                    for (std::size_t x = 0; x < width; ++x) {
+                        residual_sums[x] += sums[x];
+                    }
+                }
+                for (std::size_t x = 0; x < width; ++x) {
+                    wet[x] = residual_sums[x] == 0;
+                    finite_costs[x] = wet[x] ? 0.0 : 1.0 / (residual_sums[x] / residual_area + 1e-10);
+                }
+                _horizontal_box_sums(finite_costs, cost_columns, width, _cost_radius, cost_prefix, cost_rows + slot * width);
+                _horizontal_box_sums(wet, cost_columns, width, _cost_radius, wet_prefix, wet_rows + slot * width);
+            }
+            return slot;
+        };
+
+        // 3. rho = imfilter(rho, average 15x15, 'symmetric'), a running window adds the
+        // entering row and drops the leaving one so the cost does not depend on the radius.
+        double* cost_window = memory.get<double>(_cost_window_buffer, width);
+        std::uint32_t* wet_window = memory.get<std::uint32_t>(_wet_window_buffer, width);
+        std::fill(cost_window, cost_window + width, 0.0);
+        std::fill(wet_window, wet_window + width, 0u);
+        const std::ptrdiff_t cost_radius = static_cast<std::ptrdiff_t>(_cost_radius);
+        for (std::ptrdiff_t y = static_cast<std::ptrdiff_t>(first_row) - cost_radius; y < static_cast<std::ptrdiff_t>(first_row) + cost_radius; ++y) {
+            const std::size_t slot = cost_row(row_at(y, height));
+            for (std::size_t x = 0; x < width; ++x) {
+                cost_window[x] += cost_rows[slot * width + x];
+                wet_window[x] += wet_rows[slot * width + x];
+            }
+        }
+        for (std::size_t y = first_row; y < first_row + rows_count; ++y) {
+            const std::size_t entering = cost_row(row_at(static_cast<std::ptrdiff_t>(y) + cost_radius, height));
+            const std::size_t leaving = cost_row(row_at(static_cast<std::ptrdiff_t>(y) - cost_radius, height));
+            const double* entering_costs = cost_rows + entering * width;
+            const double* leaving_costs = cost_rows + leaving * width;
+            const std::uint32_t* entering_wet = wet_rows + entering * width;
+            const std::uint32_t* leaving_wet = wet_rows + leaving * width;
+            float* rho_row = rho + (y - first_row) * width;
+            for (std::size_t x = 0; x < width; ++x) {
+                const double costs = cost_window[x] + entering_costs[x];
+                const std::uint32_t wets = wet_window[x] + entering_wet[x];
+                const double value = (wets * static_cast<double>(wet_cost) + costs) / cost_area;
+                rho_row[x] = static_cast<float>(std::min(value, static_cast<double>(wet_cost)));
+                cost_window[x] = costs - leaving_costs[x];
+                wet_window[x] = wets - leaving_wet[x];
+            }
+        }
+    }
+
+} // namespace
+
+void cost_hill(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    std::vector<float>& rho)
+{
+    cost_hill(Y, width, height, cost_options {}, rho);
+}
+
+void cost_hill(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    const cost_options& options,
+    std::vector<float>& rho)
+{
+    if (Y.size() != width * height) {
+        throw std::runtime_error("cost_hill: y.size() must be equal to width * height");
+    }
+
+    rho.resize(width * height);
+    cost_hill(Y.data(), width, height, options, rho.data());
+}
+
+void cost_hill(
+    const std::uint8_t* Y,
+    const std::size_t width,
+    const std::size_t height,
+    const cost_options& options,
+    float* rho)
+{
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    for_each_cost_tile(height, options, [&](const std::size_t first_row, const std::size_t rows_count, scratch& memory) {
+        _cost_hill_rows(Y, width, height, first_row, rows_count, memory, rho + first_row * width);
+    });
+}
+
+void price_hill(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    std::vector<std::uint8_t>& price)
+{
+    price_hill(Y, width, height, cost_options {}, price);
+}
+
+void price_hill(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    const cost_options& options,
+    std::vector<std::uint8_t>& price)
+{
+    std::vector<float> rho;
+    cost_hill(Y, width, height, options, rho);
+    quantize_costs(rho, options, price);
+}
+
+bool embed_hill(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const std::vector<std::uint8_t>& payload_bits,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    bit_vector payload_packed;
+    pack_bits(payload_bits, payload_packed);
+    return embed_hill(rgb, width, height, steg_key, constraint_height, payload_packed, rgb_embedded, cost_embedded);
+}
+
+bool embed_hill(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_hill(rgb, width, height, steg_key, constraint_height, payload_bits, embed_options {}, rgb_embedded, cost_embedded);
+}
+
+bool embed_hill(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<hill_cost_model>(rgb, width, height, steg_key, constraint_height, payload_bits, options, rgb_embedded, cost_embedded);
+}
+
+void extract_hill(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    std::vector<std::uint8_t>& payload_bits_out)
+{
+    bit_vector payload_packed;
+    extract_hill(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, payload_packed);
+    unpack_bits(payload_packed, payload_bits_out);
+}
+
+void extract_hill(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, payload_bits_out);
+}
+
+bool embed_hill(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    workspace& memory,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<hill_cost_model>(rgb, width, height, steg_key, constraint_height, payload_bits, options, memory, rgb_embedded, cost_embedded);
+}
+
+void extract_hill(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    workspace& memory,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, options, memory, payload_bits_out);
+}
+
+bool embed_hill(
+    const image_view& image,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    workspace& memory,
+    const mutable_image_view& image_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<hill_cost_model>(image, steg_key, constraint_height, payload_bits, options, memory, image_embedded, cost_embedded);
+}
+
+void extract_hill(
+    const image_view& image_stego,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    workspace& memory,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(image_stego, steganography_key, constraint_height, max_payload_bit_count, options, memory, payload_bits_out);
+}
+
+} // namespace binghamton
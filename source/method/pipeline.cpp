@@ -0,0 +1,541 @@
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+#include <binghamton/core/lsb.hpp>
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/core/stc.hpp>
+#include <binghamton/core/ycbcr.hpp>
+#include <binghamton/method/pipeline.hpp>
+
+namespace binghamton {
+namespace {
+
+    // Planes of the workspace
+    enum _plane : std::size_t {
+        _y_plane,
+        _rho_plane,
+        _price_plane,
+        _permutation_plane,
+        _price_stc_plane
+    };
+
+    // The header is written in the LSBs of the first pixels that are not clipping, each field
+    // MSB first: a magic number, the header version, the permutation version, the payload bit
+    // count and the CRC-32 of the payload. It is masked by a key stream so that it looks random
+    // without the key.
+    constexpr std::uint64_t _header_magic = 0xb16e;
+    constexpr std::uint64_t _header_version = 1;
+    constexpr std::size_t _magic_bits = 16, _version_bits = 8, _permutation_bits = 8, _length_bits = 32, _checksum_bits = 32;
+    static_assert(_magic_bits + _version_bits + _permutation_bits + _length_bits + _checksum_bits == payload_header_bits, "header fields must fill the header");
+
+    // Header bits packed 64 per word, and the pixel holding each of them
+    using _header_words = std::array<std::uint64_t, 2>;
+    using _header_pixels = std::array<std::size_t, payload_header_bits>;
+    constexpr std::uint64_t _header_last_word_mask = (std::uint64_t(1) << (payload_header_bits - 64)) - 1;
+
+    // Finds the pixels of the header, so that it never has to move a clipping pixel. Flips keep
+    // pixels clipping or not, the extraction finds the same pixels in the stego image.
+    // Returns the count of pixels the header spans, the payload pixels coming after them.
+    std::size_t _find_header_pixels(const image_view& image, _header_pixels& pixels, const char* message)
+    {
+        if (find_unclipped_pixels(image, pixels.size(), pixels.data()) != pixels.size()) {
+            throw std::runtime_error(message);
+        }
+        return pixels.back() + 1;
+    }
+
+    void _put_field(const std::uint64_t value, const std::size_t bit_count, std::size_t& position, _header_words& words)
+    {
+        for (std::size_t i = 0; i < bit_count; ++i, ++position) {
+            words[position / 64] |= ((value >> (bit_count - 1 - i)) & 1u) << (position % 64);
+        }
+    }
+
+    // Masks or unmasks the header with the key stream
+    void _mask_header(const std::array<std::uint8_t, 32>& steg_key, _header_words& words)
+    {
+        _header_words mask;
+        make_key_stream(steg_key, mask.size(), mask.data());
+        words[0] ^= mask[0];
+        words[1] ^= mask[1] & _header_last_word_mask;
+    }
+
+    std::uint64_t _get_field(const _header_words& words, const std::size_t bit_count, std::size_t& position)
+    {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < bit_count; ++i, ++position) {
+            value = (value << 1) | ((words[position / 64] >> (position % 64)) & 1u);
+        }
+        return value;
+    }
+
+    // Reads the header from the pixels it occupies alone, so that an image without one is
+    // rejected before its whole LSB plane is extracted
+    void _read_header(
+        const image_view& image,
+        const std::array<std::uint8_t, 32>& steg_key,
+        const extract_options& options,
+        bit_vector& symbols,
+        std::size_t& header_span,
+        std::size_t& payload_bit_count,
+        std::uint32_t& checksum)
+    {
+        _header_pixels pixels;
+        header_span = _find_header_pixels(image, pixels, "extract_luminance: image has too few pixels that are not clipping to contain the payload header");
+        image_view header_image = image;
+        header_image.height = (header_span + image.width - 1) / image.width;
+        encode_y_lsb(header_image, symbols);
+        _header_words words = {};
+        for (std::size_t i = 0; i < payload_header_bits; ++i) {
+            words[i / 64] |= static_cast<std::uint64_t>(symbols.get(pixels[i])) << (i % 64);
+        }
+        _mask_header(steg_key, words);
+
+        std::size_t position = 0;
+        if (_get_field(words, _magic_bits, position) != _header_magic) {
+            throw std::runtime_error("extract_luminance: image carries no payload header");
+        }
+        if (_get_field(words, _version_bits, position) != _header_version) {
+            throw std::runtime_error("extract_luminance: unsupported payload header version");
+        }
+        if (_get_field(words, _permutation_bits, position) != static_cast<std::uint64_t>(options.permutation)) {
+            throw std::runtime_error("extract_luminance: payload was embedded with another permutation");
+        }
+        payload_bit_count = static_cast<std::size_t>(_get_field(words, _length_bits, position));
+        checksum = static_cast<std::uint32_t>(_get_field(words, _checksum_bits, position));
+    }
+
+    std::size_t _workspace_capacity(const embed_stats* stats, const workspace& memory)
+    {
+        return stats != nullptr ? memory.capacity() : 0;
+    }
+
+    void _record_workspace(embed_stats* stats, const workspace& memory, const std::size_t capacity_before)
+    {
+        if (stats != nullptr) {
+            stats->record_workspace(memory, capacity_before);
+        }
+    }
+
+    // Pixel index of each payload position, read from a table or computed by the feistel network
+    struct _permuted_indices {
+        const std::size_t* table = nullptr;
+        const feistel_permutation* feistel = nullptr;
+
+        std::size_t operator[](const std::size_t index) const
+        {
+            return table != nullptr ? table[index] : (*feistel)(index);
+        }
+    };
+
+    // Gathers the bits of a packed plane at the given indices, a word at a time.
+    void _gather_bits(
+        const bit_vector& plane,
+        const _permuted_indices& indices,
+        const std::size_t count,
+        bit_vector& bits_out)
+    {
+        bits_out.resize(count);
+        for (std::size_t word_index = 0; word_index < bits_out.words.size(); ++word_index) {
+            const std::size_t first = 64 * word_index;
+            const std::size_t last = std::min(first + 64, count);
+            std::uint64_t word = 0;
+            for (std::size_t i = first; i < last; ++i) {
+                word |= static_cast<std::uint64_t>(plane.get(indices[i])) << (i - first);
+            }
+            bits_out.words[word_index] = word;
+        }
+    }
+
+    // Gets the permutation of the payload pixels. A table comes from the cache when there is
+    // one and is computed in the workspace otherwise, the cached one staying alive with its
+    // holder. The feistel one only references the network.
+    _permuted_indices _permutation(
+        const std::array<std::uint8_t, 32>& steg_key,
+        const std::size_t first,
+        const std::size_t count,
+        const permutation_version version,
+        permutation_cache* permutations,
+        workspace& memory,
+        std::shared_ptr<const std::vector<std::size_t>>& holder,
+        const feistel_permutation& feistel)
+    {
+        _permuted_indices indices;
+        if (version == permutation_version::feistel) {
+            indices.feistel = &feistel;
+        } else if (permutations != nullptr) {
+            holder = permutations->get(steg_key, first, count, version);
+            indices.table = holder->data();
+        } else {
+            std::size_t* table = memory.planes.get<std::size_t>(_permutation_plane, count);
+            if (version == permutation_version::blocked) {
+                make_blocked_permutation(steg_key, first, count, table);
+            } else {
+                make_permutation(steg_key, first, count, table);
+            }
+            indices.table = table;
+        }
+        return indices;
+    }
+
+    bool _embed_priced_luminance(
+        const image_view& image,
+        const std::array<std::uint8_t, 32> steg_key,
+        const std::uint32_t constraint_height,
+        const bit_vector& payload_bits,
+        const bit_vector& cover_symbols,
+        const std::uint8_t* price,
+        const embed_options& options,
+        workspace& memory,
+        const mutable_image_view& image_embedded,
+        double& cost_embedded)
+    {
+        const std::size_t pixels_count = image.width * image.height;
+        embed_timer timer(options.stats);
+
+        if (pixels_count <= payload_header_bits) {
+            throw std::runtime_error("embed_priced_luminance: image too small to store the payload header");
+        }
+        if (payload_bits.size > 0xffffffffu) {
+            throw std::runtime_error("embed_priced_luminance: payload bit count cannot exceed 32 bits");
+        }
+        _header_pixels header_pixels;
+        const std::size_t header_span = _find_header_pixels(image, header_pixels, "embed_priced_luminance: image has too few pixels that are not clipping to store the payload header");
+        const std::size_t available_for_payload = pixels_count - header_span;
+
+        // 1. Cover symbols = LSBs of Y, packed 64 per word
+        if (cover_symbols.size != pixels_count) {
+            throw std::runtime_error("embed_priced_luminance: cover symbols count must be equal to width * height");
+        }
+
+        // 2. Build a key-dependent permutation of payload-carrying pixels.
+        std::shared_ptr<const std::vector<std::size_t>> permutation;
+        const feistel_permutation feistel(steg_key, header_span, available_for_payload);
+        const _permuted_indices perm_indices = _permutation(steg_key, header_span, available_for_payload, options.permutation, options.permutations, memory, permutation, feistel);
+
+        // 3. Prepare STC input in permuted order.
+        bit_vector& cover_stc = memory.cover_stc;
+        _gather_bits(cover_symbols, perm_indices, available_for_payload, cover_stc);
+
+        std::uint8_t* price_stc = memory.planes.get<std::uint8_t>(_price_stc_plane, available_for_payload);
+        for (std::size_t i = 0; i < available_for_payload; ++i) {
+            price_stc[i] = price[perm_indices[i]];
+        }
+        timer.lap(embed_stage::permutation);
+
+        // 4. Run STC on permuted data.
+        stc_options stc;
+        stc.wet_symbols = true;
+        stc.scratch = &memory.tasks;
+        bit_vector& stego_symbols_stc = memory.stego_stc;
+        cost_embedded = encode_stc(
+            cover_stc,
+            payload_bits,
+            price_stc,
+            constraint_height,
+            stc,
+            stego_symbols_stc);
+
+        if (stego_symbols_stc.size != available_for_payload) {
+            throw std::runtime_error("embed_priced_luminance: encode_stc returned wrong symbol count");
+        }
+        timer.lap(embed_stage::stc);
+
+        // 5. Flag the pixels whose LSB changes: the header, written on its own pixels, and the STC
+        // output at permuted positions. The cover symbols are read before the flags take their place.
+        _header_words header = {};
+        std::size_t position = 0;
+        _put_field(_header_magic, _magic_bits, position, header);
+        _put_field(_header_version, _version_bits, position, header);
+        _put_field(static_cast<std::uint64_t>(options.permutation), _permutation_bits, position, header);
+        _put_field(payload_bits.size, _length_bits, position, header);
+        _put_field(crc32(payload_bits), _checksum_bits, position, header);
+        _mask_header(steg_key, header);
+        _header_words header_flips = header;
+        for (std::size_t i = 0; i < payload_header_bits; ++i) {
+            header_flips[i / 64] ^= static_cast<std::uint64_t>(cover_symbols.get(header_pixels[i])) << (i % 64);
+        }
+
+        bit_vector& flips = memory.symbols;
+        flips.resize(pixels_count);
+        std::fill(flips.words.begin(), flips.words.end(), 0);
+        for (std::size_t i = 0; i < payload_header_bits; ++i) {
+            if ((header_flips[i / 64] >> (i % 64)) & 1u) {
+                flips.set(header_pixels[i], true);
+            }
+        }
+        for (std::size_t word_index = 0; word_index < stego_symbols_stc.words.size(); ++word_index) {
+            std::uint64_t changes = stego_symbols_stc.words[word_index] ^ cover_stc.words[word_index];
+            if (available_for_payload - 64 * word_index < 64) {
+                changes &= (std::uint64_t(1) << (available_for_payload - 64 * word_index)) - 1;
+            }
+            while (changes != 0) {
+                flips.set(perm_indices[64 * word_index + count_trailing_zeros(changes)], true);
+                changes &= changes - 1;
+            }
+        }
+
+        // 6. Move the Y of the flagged pixels by one, from the original pixels in one pass
+        const bool embedded = decode_y_lsb(image, flips, image_embedded); // from ycbcr.cpp
+        timer.lap(embed_stage::reinjection);
+
+        if (options.stats != nullptr) {
+            std::size_t changed_pixels_count = 0;
+            for (const std::uint64_t word : flips.words) {
+                changed_pixels_count += popcount(word);
+            }
+            options.stats->payload_bit_count += payload_bits.size;
+            options.stats->changed_pixels_count += changed_pixels_count;
+            options.stats->distortion += cost_embedded;
+        }
+        return embedded;
+    }
+
+} // namespace
+
+void embed_stats::record_workspace(const workspace& memory, const std::size_t capacity_before)
+{
+    const std::size_t capacity = memory.capacity();
+    allocated_bytes += capacity > capacity_before ? capacity - capacity_before : 0;
+    peak_workspace_bytes = std::max(peak_workspace_bytes, capacity);
+}
+
+bool embed_priced_luminance(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const std::vector<std::uint8_t>& Y,
+    const std::vector<std::uint8_t>& price,
+    const embed_options& options,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    if (rgb.size() != 3 * width * height) {
+        throw std::runtime_error("embed_priced_luminance: rgb.size() must be equal to 3 * width * height");
+    }
+    if (Y.size() != width * height) {
+        throw std::runtime_error("embed_priced_luminance: y.size() must be equal to width * height");
+    }
+    if (price.size() != width * height) {
+        throw std::runtime_error("embed_priced_luminance: price.size() must be equal to width * height");
+    }
+
+    workspace memory;
+    embed_timer timer(options.stats);
+    encode_lsb(Y, memory.symbols);
+    timer.lap(embed_stage::encode_y);
+    std::uint8_t* clipped_price = memory.planes.get<std::uint8_t>(_price_plane, price.size());
+    std::copy(price.begin(), price.end(), clipped_price);
+    wet_y_clipping(rgb.data(), price.size(), clipped_price);
+    timer.lap(embed_stage::cost);
+    rgb_embedded.resize(rgb.size());
+    const bool embedded = _embed_priced_luminance(make_image_view(rgb, width, height), steg_key, constraint_height, payload_bits, memory.symbols, clipped_price, options, memory, make_image_view(rgb_embedded, width, height), cost_embedded);
+    _record_workspace(options.stats, memory, 0);
+    return embedded;
+}
+
+bool embed_priced_luminance(
+    const image_view& image,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const std::uint8_t* y,
+    const std::uint8_t* price,
+    const embed_options& options,
+    workspace& memory,
+    const mutable_image_view& image_embedded,
+    double& cost_embedded)
+{
+    if (!is_valid(image)) {
+        throw std::runtime_error("embed_priced_luminance: image must have pixels and a stride of at least width * channels_count(layout)");
+    }
+
+    const std::size_t capacity = _workspace_capacity(options.stats, memory);
+    embed_timer timer(options.stats);
+    encode_lsb(y, image.width * image.height, memory.symbols);
+    timer.lap(embed_stage::encode_y);
+    const bool embedded = _embed_priced_luminance(image, steg_key, constraint_height, payload_bits, memory.symbols, price, options, memory, image_embedded, cost_embedded);
+    _record_workspace(options.stats, memory, capacity);
+    return embedded;
+}
+
+std::size_t payload_header_span(const image_view& image)
+{
+    if (!is_valid(image)) {
+        throw std::runtime_error("payload_header_span: image must have pixels and a stride of at least width * channels_count(layout)");
+    }
+
+    _header_pixels pixels;
+    return _find_header_pixels(image, pixels, "payload_header_span: image has too few pixels that are not clipping to store the payload header");
+}
+
+luminance_planes encode_luminance(
+    const image_view& image,
+    workspace& memory)
+{
+    if (!is_valid(image)) {
+        throw std::runtime_error("encode_luminance: image must have pixels and a stride of at least width * channels_count(layout)");
+    }
+
+    const std::size_t pixels_count = image.width * image.height;
+    luminance_planes planes;
+    planes.y = image.data;
+    if (image.layout != pixel_layout::gray || !is_packed(image)) {
+        std::uint8_t* y_plane = memory.planes.get<std::uint8_t>(_y_plane, pixels_count);
+        encode_y(image, y_plane);
+        planes.y = y_plane;
+    }
+    planes.rho = memory.planes.get<float>(_rho_plane, pixels_count);
+    planes.price = memory.planes.get<std::uint8_t>(_price_plane, pixels_count);
+    return planes;
+}
+
+bool embed_prepared(
+    const prepared_cover& cover,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    workspace memory;
+    return embed_prepared(cover, steg_key, constraint_height, payload_bits, options, memory, rgb_embedded, cost_embedded);
+}
+
+bool embed_prepared(
+    const prepared_cover& cover,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    workspace& memory,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    const std::size_t pixels_count = cover.width * cover.height;
+    if (cover.rgb.size() != 3 * pixels_count || cover.y.size() != pixels_count || cover.price.size() != pixels_count) {
+        throw std::runtime_error("embed_prepared: cover is not prepared");
+    }
+
+    const std::size_t capacity = _workspace_capacity(options.stats, memory);
+    rgb_embedded.resize(cover.rgb.size());
+    const bool embedded = _embed_priced_luminance(make_image_view(cover.rgb, cover.width, cover.height), steg_key, constraint_height, payload_bits, cover.symbols, cover.price.data(), options, memory, make_image_view(rgb_embedded, cover.width, cover.height), cost_embedded);
+    _record_workspace(options.stats, memory, capacity);
+    return embedded;
+}
+
+void extract_luminance(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, extract_options {}, payload_bits_out);
+}
+
+void extract_luminance(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    bit_vector& payload_bits_out)
+{
+    workspace memory;
+    extract_luminance(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, options, memory, payload_bits_out);
+}
+
+void extract_luminance(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    workspace& memory,
+    bit_vector& payload_bits_out)
+{
+    if (rgb_stego.size() != 3 * width * height) {
+        throw std::runtime_error("extract_luminance: rgb_stego.size() must be 3 * width * height");
+    }
+
+    extract_luminance(make_image_view(rgb_stego, width, height), steganography_key, constraint_height, max_payload_bit_count, options, memory, payload_bits_out);
+}
+
+void extract_luminance(
+    const image_view& image_stego,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    workspace& memory,
+    bit_vector& payload_bits_out)
+{
+    if (!is_valid(image_stego)) {
+        throw std::runtime_error("extract_luminance: image_stego must have pixels and a stride of at least width * channels_count(layout)");
+    }
+
+    const std::size_t pixels_count = image_stego.width * image_stego.height;
+
+    if (pixels_count <= payload_header_bits) {
+        throw std::runtime_error("extract_luminance: image too small to contain the payload header");
+    }
+    if (max_payload_bit_count > pixels_count) {
+        throw std::runtime_error("extract_luminance: max_payload_bit_count > number of pixels");
+    }
+    if (max_payload_bit_count == 0) {
+        payload_bits_out.resize(0);
+        return;
+    }
+
+    // 1. Read the header from its own pixels, failing before the rest of the image is read
+    bit_vector& stego_symbols = memory.symbols;
+    std::size_t header_span = 0;
+    std::size_t payload_bit_len = 0;
+    std::uint32_t checksum = 0;
+    _read_header(image_stego, steganography_key, options, stego_symbols, header_span, payload_bit_len, checksum);
+    const std::size_t available_for_payload = pixels_count - header_span;
+    if (payload_bit_len == 0) {
+        // No payload
+        payload_bits_out.resize(0);
+        return;
+    }
+    if (payload_bit_len > max_payload_bit_count) {
+        throw std::runtime_error("extract_luminance: encoded payload length exceeds user cap");
+    }
+    if (payload_bit_len > available_for_payload) {
+        throw std::runtime_error("extract_luminance: encoded payload length does not fit in image");
+    }
+
+    // 2. Extract the LSB plane of the stego Y from the pixels in one pass, packed 64 symbols per word
+    encode_y_lsb(image_stego, stego_symbols);
+
+    std::shared_ptr<const std::vector<std::size_t>> permutation;
+    const feistel_permutation feistel(steganography_key, header_span, available_for_payload);
+    const _permuted_indices perm_indices = _permutation(steganography_key, header_span, available_for_payload, options.permutation, options.permutations, memory, permutation, feistel);
+
+    // 3) Gather STC input in permuted order.
+    bit_vector& stc_symbols = memory.stego_stc;
+    _gather_bits(stego_symbols, perm_indices, available_for_payload, stc_symbols);
+
+    // 4) Decode STC with the known payload_bit_len
+    stc_options stc;
+    stc.scratch = &memory.tasks;
+    decode_stc(stc_symbols, constraint_height, payload_bit_len, stc, payload_bits_out);
+    if (crc32(payload_bits_out) != checksum) {
+        throw std::runtime_error("extract_luminance: payload checksum does not match");
+    }
+}
+
+} // namespace binghamton
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <binghamton/core/stc.hpp>
+#include <binghamton/core/ycbcr.hpp>
+#include <binghamton/method/simulator.hpp>
+
+namespace binghamton {
+namespace {
+
+    using _histogram = std::array<std::size_t, 256>;
+
+    constexpr std::size_t _bisection_steps = 64;
+
+    _histogram _make_histogram(const std::uint8_t* price, const std::size_t count)
+    {
+        _histogram histogram {};
+        for (std::size_t i = 0; i < count; ++i) {
+            ++histogram[price[i]];
+        }
+        return histogram;
+    }
+
+    // Fills the embedding of a lambda from the histogram of the prices, wet prices never changing
+    void _evaluate(const _histogram& histogram, const double lambda, gibbs_embedding& embedding)
+    {
+        embedding.lambda = lambda;
+        embedding.payload_bit_count = 0.0;
+        embedding.distortion = 0.0;
+        embedding.changed_pixels_count = 0.0;
+        embedding.probability.fill(0.0);
+        for (std::size_t price = 0; price < wet_price; ++price) {
+            const double exponential = std::exp(-lambda * static_cast<double>(price));
+            const double probability = exponential / (1.0 + exponential);
+            embedding.probability[price] = probability;
+            if (histogram[price] == 0 || probability <= 0.0) {
+                continue;
+            }
+            const double pixels_count = static_cast<double>(histogram[price]);
+            const double entropy = probability >= 0.5 ? 1.0 : -probability * std::log2(probability) - (1.0 - probability) * std::log2(1.0 - probability);
+            embedding.payload_bit_count += pixels_count * entropy;
+            embedding.distortion += pixels_count * probability * static_cast<double>(price);
+            embedding.changed_pixels_count += pixels_count * probability;
+        }
+    }
+
+    // Finds the lambda whose embedding reaches a target, the measure of the embedding
+    // decreasing with lambda. The bracket grows geometrically before the bisection.
+    template <typename measure_t>
+    void _solve(const _histogram& histogram, const double target, const measure_t& measure, gibbs_embedding& embedding)
+    {
+        double lower = 0.0, upper = 1.0;
+        _evaluate(histogram, upper, embedding);
+        while (measure(embedding) > target && upper < 1e6) {
+            lower = upper;
+            upper *= 2.0;
+            _evaluate(histogram, upper, embedding);
+        }
+        for (std::size_t step = 0; step < _bisection_steps; ++step) {
+            const double middle = 0.5 * (lower + upper);
+            _evaluate(histogram, middle, embedding);
+            (measure(embedding) > target ? lower : upper) = middle;
+        }
+        _evaluate(histogram, upper, embedding);
+    }
+
+    std::uint64_t _splitmix64(std::uint64_t& state)
+    {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    void _check_cover(const prepared_cover& cover, const char* message)
+    {
+        const std::size_t pixels_count = cover.width * cover.height;
+        if (pixels_count <= payload_header_bits || cover.rgb.size() != 3 * pixels_count || cover.price.size() != pixels_count) {
+            throw std::runtime_error(message);
+        }
+    }
+
+} // namespace
+
+void solve_gibbs_payload(
+    const std::uint8_t* price,
+    const std::size_t count,
+    const double payload_bit_count,
+    gibbs_embedding& embedding)
+{
+    const _histogram histogram = _make_histogram(price, count);
+    if (payload_bit_count > static_cast<double>(count - histogram[wet_price])) {
+        throw std::runtime_error("solve_gibbs_payload: payload_bit_count cannot exceed the count of dry pixels");
+    }
+
+    _solve(histogram, payload_bit_count, [](const gibbs_embedding& candidate) { return candidate.payload_bit_count; }, embedding);
+}
+
+void solve_gibbs_distortion(
+    const std::uint8_t* price,
+    const std::size_t count,
+    const double distortion,
+    gibbs_embedding& embedding)
+{
+    const _histogram histogram = _make_histogram(price, count);
+    _evaluate(histogram, 0.0, embedding);
+    if (embedding.distortion <= distortion) {
+        return;
+    }
+
+    _solve(histogram, distortion, [](const gibbs_embedding& candidate) { return candidate.distortion; }, embedding);
+}
+
+std::size_t estimate_capacity(
+    const prepared_cover& cover,
+    const double distortion)
+{
+    _check_cover(cover, "estimate_capacity: cover is not prepared");
+
+    // The pixels the header spans carry no payload
+    const std::size_t header_span = payload_header_span(make_image_view(cover.rgb, cover.width, cover.height));
+    gibbs_embedding embedding;
+    solve_gibbs_distortion(cover.price.data() + header_span, cover.price.size() - header_span, distortion, embedding);
+    return static_cast<std::size_t>(embedding.payload_bit_count);
+}
+
+bool simulate_embedding(
+    const prepared_cover& cover,
+    const std::size_t payload_bit_count,
+    const std::uint64_t seed,
+    std::vector<std::uint8_t>& rgb_embedded,
+    gibbs_embedding& embedding)
+{
+    _check_cover(cover, "simulate_embedding: cover is not prepared");
+
+    const std::size_t pixels_count = cover.width * cover.height;
+    const std::size_t header_span = payload_header_span(make_image_view(cover.rgb, cover.width, cover.height));
+    solve_gibbs_payload(cover.price.data() + header_span, pixels_count - header_span, static_cast<double>(payload_bit_count), embedding);
+
+    // Each pixel changes when a 32-bit draw falls under the threshold of its price, two draws
+    // per random word
+    std::array<std::uint32_t, 256> thresholds {};
+    for (std::size_t price = 0; price < thresholds.size(); ++price) {
+        thresholds[price] = static_cast<std::uint32_t>(std::min(embedding.probability[price] * 4294967296.0, 4294967295.0));
+    }
+    bit_vector flips;
+    flips.resize(pixels_count);
+    std::uint64_t state = seed;
+    std::uint64_t random = 0;
+    for (std::size_t i = header_span; i < pixels_count; ++i) {
+        if ((i - header_span) % 2 == 0) {
+            random = _splitmix64(state);
+        }
+        const std::uint32_t draw = static_cast<std::uint32_t>(random >> (32 * ((i - header_span) % 2)));
+        if (draw < thresholds[cover.price[i]]) {
+            flips.words[i / 64] |= std::uint64_t(1) << (i % 64);
+        }
+    }
+
+    rgb_embedded.resize(cover.rgb.size());
+    return decode_y_lsb(make_image_view(cover.rgb, cover.width, cover.height), flips, make_image_view(rgb_embedded, cover.width, cover.height));
+}
+
+}
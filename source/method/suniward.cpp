@@ -0,0 +1,173 @@
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <binghamton/method/pipeline.hpp>
+#include <binghamton/method/suniward.hpp>
+#include <binghamton/method/wavelet.hpp>
+
+namespace binghamton {
+
+void cost_suniward(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    std::vector<float>& rho)
+{
+    cost_wavelet(Y, width, height, wavelet_cost::suniward, rho);
+}
+
+void cost_suniward(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    const cost_options& options,
+    std::vector<float>& rho)
+{
+    cost_wavelet(Y, width, height, wavelet_cost::suniward, options, rho);
+}
+
+void price_suniward(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    std::vector<std::uint8_t>& price)
+{
+    price_suniward(Y, width, height, cost_options {}, price);
+}
+
+void price_suniward(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    const cost_options& options,
+    std::vector<std::uint8_t>& price)
+{
+    std::vector<float> rho;
+    cost_suniward(Y, width, height, options, rho);
+    quantize_costs(rho, options, price);
+}
+
+bool embed_suniward(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const std::vector<std::uint8_t>& payload_bits,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    bit_vector payload_packed;
+    pack_bits(payload_bits, payload_packed);
+    return embed_suniward(rgb, width, height, steg_key, constraint_height, payload_packed, rgb_embedded, cost_embedded);
+}
+
+bool embed_suniward(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_suniward(rgb, width, height, steg_key, constraint_height, payload_bits, embed_options {}, rgb_embedded, cost_embedded);
+}
+
+bool embed_suniward(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<suniward_cost_model>(rgb, width, height, steg_key, constraint_height, payload_bits, options, rgb_embedded, cost_embedded);
+}
+
+void extract_suniward(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    std::vector<std::uint8_t>& payload_bits_out)
+{
+    bit_vector payload_packed;
+    extract_suniward(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, payload_packed);
+    unpack_bits(payload_packed, payload_bits_out);
+}
+
+void extract_suniward(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, payload_bits_out);
+}
+
+bool embed_suniward(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    workspace& memory,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<suniward_cost_model>(rgb, width, height, steg_key, constraint_height, payload_bits, options, memory, rgb_embedded, cost_embedded);
+}
+
+void extract_suniward(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    workspace& memory,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, options, memory, payload_bits_out);
+}
+
+bool embed_suniward(
+    const image_view& image,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    workspace& memory,
+    const mutable_image_view& image_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<suniward_cost_model>(image, steg_key, constraint_height, payload_bits, options, memory, image_embedded, cost_embedded);
+}
+
+void extract_suniward(
+    const image_view& image_stego,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    workspace& memory,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(image_stego, steganography_key, constraint_height, max_payload_bit_count, options, memory, payload_bits_out);
+}
+
+} // namespace binghamton
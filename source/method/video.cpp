@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <binghamton/method/video.hpp>
+
+namespace binghamton {
+namespace {
+
+    void _check_frame(const yuv420_frame& frame, const char* message)
+    {
+        if (frame.y == nullptr || frame.width == 0 || frame.height == 0 || frame.y_stride < frame.width) {
+            throw std::runtime_error(message);
+        }
+    }
+
+}
+
+mutable_image_view luma_view(const yuv420_frame& frame)
+{
+    return mutable_image_view { frame.y, frame.width, frame.height, frame.y_stride, pixel_layout::gray };
+}
+
+sequence_embedder::sequence_embedder(
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const std::size_t frame_bit_count,
+    const embed_options& options)
+    : _steg_key(steg_key)
+    , _constraint_height(constraint_height)
+    , _payload_bits(payload_bits)
+    , _frame_bit_count(frame_bit_count)
+    , _options(options)
+{
+    if (frame_bit_count == 0) {
+        throw std::runtime_error("sequence_embedder: frame_bit_count cannot be 0");
+    }
+    if (_options.permutations == nullptr) {
+        _options.permutations = &_permutations;
+    }
+}
+
+bool sequence_embedder::_next_frame_bits(const yuv420_frame& frame)
+{
+    _check_frame(frame, "sequence_embedder: frame must have a luma plane and a y_stride of at least width");
+    if (_finished) {
+        return false;
+    }
+
+    // A frame carrying fewer bits than frame_bit_count ends the payload, when the payload
+    // is a multiple of it the last frame carries none
+    const std::size_t bit_count = std::min(_frame_bit_count, _payload_bits.size - _embedded_bit_count);
+    _frame_bits.resize(bit_count);
+    for (std::size_t index = 0; index < bit_count; ++index) {
+        _frame_bits.set(index, _payload_bits.get(_embedded_bit_count + index));
+    }
+    _embedded_bit_count += bit_count;
+    _finished = bit_count < _frame_bit_count;
+    return true;
+}
+
+bool sequence_embedder::finished() const
+{
+    return _finished;
+}
+
+std::size_t sequence_embedder::embedded_bit_count() const
+{
+    return _embedded_bit_count;
+}
+
+sequence_extractor::sequence_extractor(
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const std::size_t frame_bit_count,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options)
+    : _steg_key(steg_key)
+    , _constraint_height(constraint_height)
+    , _frame_bit_count(frame_bit_count)
+    , _max_payload_bit_count(max_payload_bit_count)
+    , _options(options)
+{
+    if (frame_bit_count == 0) {
+        throw std::runtime_error("sequence_extractor: frame_bit_count cannot be 0");
+    }
+    if (_options.permutations == nullptr) {
+        _options.permutations = &_permutations;
+    }
+}
+
+void sequence_extractor::extract_frame(const yuv420_frame& frame)
+{
+    _check_frame(frame, "sequence_extractor: frame must have a luma plane and a y_stride of at least width");
+    if (_finished) {
+        return;
+    }
+
+    const std::size_t bit_count = std::min(_frame_bit_count, frame.width * frame.height);
+    extract_luminance(luma_view(frame), _steg_key, _constraint_height, bit_count, _options, _memory, _frame_bits);
+    if (_payload_bits.size + _frame_bits.size > _max_payload_bit_count) {
+        throw std::runtime_error("sequence_extractor: payload length exceeds max_payload_bit_count");
+    }
+
+    const std::size_t first = _payload_bits.size;
+    _payload_bits.resize(first + _frame_bits.size);
+    for (std::size_t index = 0; index < _frame_bits.size; ++index) {
+        _payload_bits.set(first + index, _frame_bits.get(index));
+    }
+    _finished = _frame_bits.size < _frame_bit_count;
+}
+
+bool sequence_extractor::finished() const
+{
+    return _finished;
+}
+
+const bit_vector& sequence_extractor::payload_bits() const
+{
+    return _payload_bits;
+}
+
+}
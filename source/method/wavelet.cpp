@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <binghamton/method/convolution.hpp>
+#include <binghamton/method/cost.hpp>
+#include <binghamton/method/wavelet.hpp>
+
+namespace binghamton {
+namespace {
+
+    // High-pass decomposition filter of the 8-tap Daubechies wavelet (16 coefficients)
+    // used by the WOW and S-UNIWARD directional filter bank.
+    static const std::vector<float> _daubechies8_high_pass = {
+        -0.0544158422f, 0.3128715909f, -0.6756307363f, 0.5853546837f,
+        0.0158291053f, -0.2840155430f, -0.0004724846f, 0.1287474266f,
+        0.0173693010f, -0.0440882539f, -0.0139810279f, 0.0087460940f,
+        0.0048703530f, -0.0003917404f, -0.0006754494f, -0.0001174768f
+    };
+
+    // Buffers of the scratch of one tile
+    enum _tile_buffer : std::size_t {
+        _padded_columns_buffer,
+        _padded_buffer,
+        _columns_low_buffer,
+        _columns_high_buffer,
+        _residual_buffer,
+        _suitability_columns_buffer,
+        _suitability_buffer
+    };
+
+    // Stabilizing constant sigma of S-UNIWARD, keeps 1 / (|R| + sigma) finite on flat areas
+    constexpr float _suniward_stabilizer = 1.0f;
+
+    // Filters of the bank. Each 2-D filter is the outer product of the low-pass and
+    // high-pass filters, LH = lp' * hp, HL = hp' * lp and HH = hp' * hp, so that the
+    // residuals and the suitabilities are computed as a column pass followed by a row pass.
+    struct _filter_bank {
+        _filter_bank()
+        {
+            const std::vector<float>& high_pass = _daubechies8_high_pass;
+            const std::size_t taps_count = high_pass.size();
+            std::vector<float> low_pass(taps_count);
+            for (std::size_t t = 0; t < taps_count; ++t) {
+                low_pass[t] = (t % 2 == 0 ? 1.0f : -1.0f) * high_pass[taps_count - 1 - t];
+            }
+            const auto reversed = [](std::vector<float> taps) {
+                std::reverse(taps.begin(), taps.end());
+                return taps;
+            };
+            const auto absolute = [](std::vector<float> taps) {
+                for (float& tap : taps) {
+                    tap = std::fabs(tap);
+                }
+                return taps;
+            };
+            low_pass_reversed = reversed(low_pass);
+            high_pass_reversed = reversed(high_pass);
+            low_pass_absolute = absolute(low_pass);
+            high_pass_absolute = absolute(high_pass);
+        }
+
+        std::vector<float> low_pass_reversed;
+        std::vector<float> high_pass_reversed;
+        std::vector<float> low_pass_absolute;
+        std::vector<float> high_pass_absolute;
+    };
+
+    // Directional costs of the rows [first_row, first_row + rows_count) for a given cost
+    // model, the per-pixel transforms being resolved at compile time. Rows are read with
+    // the halo of the filters around the tile, and every output goes through the same
+    // direct correlations whatever the tile, so tiles reproduce a whole-image pass exactly.
+    template <wavelet_cost cost_model>
+    void _cost_wavelet_rows(
+        const std::uint8_t* Y,
+        const std::size_t width,
+        const std::size_t height,
+        const _filter_bank& bank,
+        const std::size_t first_row,
+        const std::size_t rows_count,
+        scratch& memory,
+        float* rho)
+    {
+        const std::size_t taps_count = _daubechies8_high_pass.size();
+        const std::size_t tile_pixels_count = width * rows_count;
+        std::fill(rho, rho + tile_pixels_count, 0.0f);
+
+        // 1. Symmetric padding by the filter size.
+        const std::size_t padding = taps_count;
+        const std::size_t padded_width = width + 2 * padding;
+        const std::size_t padded_height = rows_count + 2 * padding;
+        std::size_t* padded_columns = memory.get<std::size_t>(_padded_columns_buffer, padded_width);
+        for (std::size_t x = 0; x < padded_width; ++x) {
+            padded_columns[x] = symmetric_index(static_cast<std::ptrdiff_t>(x) - static_cast<std::ptrdiff_t>(padding), width);
+        }
+        float* padded = memory.get<float>(_padded_buffer, padded_width * padded_height);
+        for (std::size_t y = 0; y < padded_height; ++y) {
+            const std::ptrdiff_t source_y = static_cast<std::ptrdiff_t>(first_row + y) - static_cast<std::ptrdiff_t>(padding);
+            const std::uint8_t* source_row = Y + symmetric_index(source_y, height) * width;
+            float* padded_row = padded + y * padded_width;
+            for (std::size_t x = 0; x < padded_width; ++x) {
+                padded_row[x] = static_cast<float>(source_row[padded_columns[x]]);
+            }
+        }
+
+        // 2. Residuals R = conv2(padded, F, 'same') are needed 8 pixels around the image for
+        // the suitability, that is correlating with the flipped filter from padded offset 1.
+        // The column passes are shared by the filters using the same vertical filter.
+        const std::size_t residual_width = width + taps_count;
+        const std::size_t residual_height = rows_count + taps_count;
+        float* columns_low = memory.get<float>(_columns_low_buffer, residual_height * padded_width);
+        float* columns_high = memory.get<float>(_columns_high_buffer, residual_height * padded_width);
+        correlate_columns(padded + padded_width, padded_width, padded_width, residual_height, bank.low_pass_reversed, columns_low, padded_width, convolution_method::direct);
+        correlate_columns(padded + padded_width, padded_width, padded_width, residual_height, bank.high_pass_reversed, columns_high, padded_width, convolution_method::direct);
+
+        struct directional_filter {
+            const float* columns;
+            const std::vector<float>& row_taps;
+            const std::vector<float>& vertical_absolute;
+            const std::vector<float>& horizontal_absolute;
+        };
+        const directional_filter filters[3] = {
+            { columns_low, bank.high_pass_reversed, bank.low_pass_absolute, bank.high_pass_absolute }, // LH
+            { columns_high, bank.low_pass_reversed, bank.high_pass_absolute, bank.low_pass_absolute }, // HL
+            { columns_high, bank.high_pass_reversed, bank.high_pass_absolute, bank.high_pass_absolute }, // HH
+        };
+
+        const std::size_t residual_count = residual_height * residual_width;
+        float* residual = memory.get<float>(_residual_buffer, residual_count);
+        float* suitability_columns = memory.get<float>(_suitability_columns_buffer, rows_count * residual_width);
+        float* suitability = memory.get<float>(_suitability_buffer, tile_pixels_count);
+        for (const directional_filter& filter : filters) {
+            correlate_rows(filter.columns + 1, padded_width, residual_width, residual_height, filter.row_taps, residual, residual_width, convolution_method::direct);
+            if constexpr (cost_model == wavelet_cost::wow) {
+                for (std::size_t i = 0; i < residual_count; ++i) {
+                    residual[i] = std::fabs(residual[i]);
+                }
+            } else {
+                for (std::size_t i = 0; i < residual_count; ++i) {
+                    residual[i] = 1.0f / (std::fabs(residual[i]) + _suniward_stabilizer);
+                }
+            }
+
+            // 3. Suitability xi = conv2(|R|, rot90(|F|, 2), 'same') for WOW, or
+            // conv2(1 ./ (|R| + sigma), rot90(|F|, 2), 'same') for S-UNIWARD, shifted by one
+            // pixel down and right for the even filter size, a correlation with |F|.
+            correlate_columns(residual, residual_width, residual_width, rows_count, filter.vertical_absolute, suitability_columns, residual_width, convolution_method::direct);
+            correlate_rows(suitability_columns, residual_width, width, rows_count, filter.horizontal_absolute, suitability, width, convolution_method::direct);
+
+            // 4. Hölder norm with p = -1 of the three suitabilities for WOW, their sum
+            // for S-UNIWARD
+            if constexpr (cost_model == wavelet_cost::wow) {
+                for (std::size_t i = 0; i < tile_pixels_count; ++i) {
+                    rho[i] += 1.0f / suitability[i];
+                }
+            } else {
+                for (std::size_t i = 0; i < tile_pixels_count; ++i) {
+                    rho[i] += suitability[i];
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < tile_pixels_count; ++i) {
+            if (!(rho[i] <= wet_cost)) {
+                rho[i] = wet_cost;
+            }
+        }
+    }
+
+} // namespace
+
+void cost_wavelet(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    const wavelet_cost cost_model,
+    std::vector<float>& rho)
+{
+    cost_wavelet(Y, width, height, cost_model, cost_options {}, rho);
+}
+
+void cost_wavelet(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    const wavelet_cost cost_model,
+    const cost_options& options,
+    std::vector<float>& rho)
+{
+    if (Y.size() != width * height) {
+        throw std::runtime_error("cost_wavelet: y.size() must be equal to width * height");
+    }
+
+    rho.resize(width * height);
+    cost_wavelet(Y.data(), width, height, cost_model, options, rho.data());
+}
+
+void cost_wavelet(
+    const std::uint8_t* Y,
+    const std::size_t width,
+    const std::size_t height,
+    const wavelet_cost cost_model,
+    const cost_options& options,
+    float* rho)
+{
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    static const _filter_bank bank;
+    for_each_cost_tile(height, options, [&](const std::size_t first_row, const std::size_t rows_count, scratch& memory) {
+        float* rho_rows = rho + first_row * width;
+        if (cost_model == wavelet_cost::wow) {
+            _cost_wavelet_rows<wavelet_cost::wow>(Y, width, height, bank, first_row, rows_count, memory, rho_rows);
+        } else {
+            _cost_wavelet_rows<wavelet_cost::suniward>(Y, width, height, bank, first_row, rows_count, memory, rho_rows);
+        }
+    });
+}
+
+} // namespace binghamton
@@ -0,0 +1,112 @@
+#include <binghamton/method/workspace.hpp>
+
+namespace binghamton {
+namespace {
+
+    void _release(bit_vector& bits)
+    {
+        bits.words.clear();
+        bits.words.shrink_to_fit();
+        bits.size = 0;
+    }
+
+} // namespace
+
+workspace::workspace(std::pmr::memory_resource* resource)
+    : planes(resource)
+    , bands(resource)
+    , tasks(resource)
+    , symbols { std::pmr::vector<std::uint64_t>(resource) }
+    , cover_stc { std::pmr::vector<std::uint64_t>(resource) }
+    , stego_stc { std::pmr::vector<std::uint64_t>(resource) }
+{
+}
+
+std::size_t workspace::capacity() const
+{
+    const std::size_t words_count = symbols.words.capacity() + cover_stc.words.capacity() + stego_stc.words.capacity();
+    return planes.capacity() + bands.capacity() + tasks.capacity() + words_count * sizeof(std::uint64_t);
+}
+
+std::pmr::memory_resource* workspace::resource() const
+{
+    return planes.resource();
+}
+
+void workspace::release()
+{
+    planes.release();
+    bands.release();
+    tasks.release();
+    _release(symbols);
+    _release(cover_stc);
+    _release(stego_stc);
+}
+
+workspace_pool::lease::lease(workspace_pool* pool, workspace* value)
+    : _pool(pool)
+    , _workspace(value)
+{
+}
+
+workspace_pool::lease::lease(lease&& other) noexcept
+    : _pool(other._pool)
+    , _workspace(other._workspace)
+{
+    other._pool = nullptr;
+    other._workspace = nullptr;
+}
+
+workspace_pool::lease::~lease()
+{
+    if (_pool != nullptr) {
+        // _available was grown with _workspaces, giving a workspace back never allocates
+        std::lock_guard<std::mutex> _lock(_pool->_mutex);
+        _pool->_available.push_back(_workspace);
+    }
+}
+
+workspace_pool::workspace_pool(std::pmr::memory_resource* resource)
+    : _resource(resource)
+    , _workspaces(resource)
+    , _available(resource)
+{
+}
+
+workspace_pool::lease workspace_pool::acquire()
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    if (_available.empty()) {
+        _workspaces.emplace_back(_resource);
+        _available.reserve(_workspaces.size());
+        return lease(this, &_workspaces.back());
+    }
+    workspace* _workspace = _available.back();
+    _available.pop_back();
+    return lease(this, _workspace);
+}
+
+std::size_t workspace_pool::capacity() const
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    std::size_t _bytes = 0;
+    for (const workspace& _workspace : _workspaces) {
+        _bytes += _workspace.capacity();
+    }
+    return _bytes;
+}
+
+std::pmr::memory_resource* workspace_pool::resource() const
+{
+    return _resource;
+}
+
+void workspace_pool::release()
+{
+    std::lock_guard<std::mutex> _lock(_mutex);
+    for (workspace& _workspace : _workspaces) {
+        _workspace.release();
+    }
+}
+
+} // namespace binghamton
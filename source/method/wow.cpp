@@ -1,143 +1,52 @@
-#include <algorithm>
-#include <cmath>
-#include <stdexcept>
+#include <array>
+#include <cstddef>
 #include <vector>
 
-#include <binghamton/core/lsb.hpp>
-#include <binghamton/core/stc.hpp>
-#include <binghamton/core/ycbcr.hpp>
+#include <binghamton/method/pipeline.hpp>
+#include <binghamton/method/wavelet.hpp>
 #include <binghamton/method/wow.hpp>
 
 namespace binghamton {
-namespace {
 
-    // ... existing Kx, Ky, Kd, _convolve3x3, etc.
-
-    std::uint64_t _hash_key_to_seed(const std::array<std::uint8_t, 32>& key)
-    {
-        // Simple 64-bit hash / mixer (FNV-1a style + mixing)
-        std::uint64_t h = 0x9e3779b97f4a7c15ULL;
-        for (auto b : key) {
-            h ^= static_cast<std::uint64_t>(b) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
-        }
-        if (h == 0) {
-            h = 0xdeadbeefcafebabeULL; // avoid zero state
-        }
-        return h;
-    }
-
-    struct StegoRng {
-        std::uint64_t state;
-
-        explicit StegoRng(const std::array<std::uint8_t, 32>& key)
-            : state(_hash_key_to_seed(key))
-        {
-        }
-
-        std::size_t next(std::size_t bound)
-        {
-            // xorshift* PRNG
-            std::uint64_t x = state;
-            x ^= x >> 12;
-            x ^= x << 25;
-            x ^= x >> 27;
-            state = x;
-            std::uint64_t r = x * 2685821657736338717ULL;
-            return static_cast<std::size_t>(r % bound);
-        }
-    };
-
-    void make_permutation(
-        const std::array<std::uint8_t, 32>& steg_key,
-        std::size_t first,
-        std::size_t count,
-        std::vector<std::size_t>& indices_out)
-    {
-        indices_out.resize(count);
-        for (std::size_t i = 0; i < count; ++i) {
-            indices_out[i] = first + i; // pixel indices [first .. first+count)
-        }
-
-        StegoRng rng(steg_key);
-        // Fisher–Yates shuffle
-        for (std::size_t i = count; i > 1; --i) {
-            std::size_t j = rng.next(i); // 0 <= j < i
-            std::swap(indices_out[i - 1], indices_out[j]);
-        }
-    }
-
-    // Horizontal high-pass
-    static const float Kx[3][3] = {
-        { 0.f, 0.f, 0.f },
-        { -1.f, 2.f, -1.f },
-        { 0.f, 0.f, 0.f }
-    };
-
-    // Vertical high-pass
-    static const float Ky[3][3] = {
-        { 0.f, -1.f, 0.f },
-        { 0.f, 2.f, 0.f },
-        { 0.f, -1.f, 0.f }
-    };
-
-    // Diagonal high-pass
-    static const float Kd[3][3] = {
-        { -1.f, 0.f, 0.f },
-        { 0.f, 2.f, 0.f },
-        { 0.f, 0.f, -1.f }
-    };
-
-    constexpr float epsilon = 1e-3f; // avoid division by zero
-
-    inline std::uint8_t _clamp_u8(float v)
-    {
-        if (v < 0.0f)
-            v = 0.0f;
-        if (v > 255.0f)
-            v = 255.0f;
-        return static_cast<std::uint8_t>(std::lround(v));
-    }
+void cost_wow(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    std::vector<float>& rho)
+{
+    cost_wavelet(Y, width, height, wavelet_cost::wow, rho);
+}
 
-    // Safe access with clamping at borders
-    inline float _get_y_pixel(const std::vector<std::uint8_t>& Y,
-        std::size_t width,
-        std::size_t height,
-        int x, int y)
-    {
-        if (x < 0)
-            x = 0;
-        if (y < 0)
-            y = 0;
-        if (x >= (int)width)
-            x = static_cast<int>(width) - 1;
-        if (y >= (int)height)
-            y = static_cast<int>(height) - 1;
-        return static_cast<float>(Y[static_cast<std::size_t>(y) * width + static_cast<std::size_t>(x)]);
-    }
+void cost_wow(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    const cost_options& options,
+    std::vector<float>& rho)
+{
+    cost_wavelet(Y, width, height, wavelet_cost::wow, options, rho);
+}
 
-    // Simple 3x3 convolution on Y plane
-    void _convolve3x3(const std::vector<std::uint8_t>& Y,
-        std::size_t width,
-        std::size_t height,
-        const float kernel[3][3],
-        std::vector<float>& out)
-    {
-        out.resize(width * height);
-        for (std::size_t yy = 0; yy < height; ++yy) {
-            for (std::size_t xx = 0; xx < width; ++xx) {
-                float acc = 0.0f;
-                for (int ky = -1; ky <= 1; ++ky) {
-                    for (int kx = -1; kx <= 1; ++kx) {
-                        float w = kernel[ky + 1][kx + 1];
-                        acc += w * _get_y_pixel(Y, width, height, static_cast<int>(xx) + kx, static_cast<int>(yy) + ky);
-                    }
-                }
-                out[yy * width + xx] = acc;
-            }
-        }
-    }
+void price_wow(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    std::vector<std::uint8_t>& price)
+{
+    price_wow(Y, width, height, cost_options {}, price);
+}
 
-} // namespace
+void price_wow(
+    const std::vector<std::uint8_t>& Y,
+    const std::size_t width,
+    const std::size_t height,
+    const cost_options& options,
+    std::vector<std::uint8_t>& price)
+{
+    std::vector<float> rho;
+    cost_wow(Y, width, height, options, rho);
+    quantize_costs(rho, options, price);
+}
 
 bool embed_wow(
     const std::vector<std::uint8_t>& rgb,
@@ -149,114 +58,36 @@ bool embed_wow(
     std::vector<std::uint8_t>& rgb_embedded,
     double& cost_embedded)
 {
-    if (rgb.size() != 3 * width * height) {
-        throw std::runtime_error("embed_wow: rgb.size() must be equal to 3 * width * height");
-    }
-
-    const std::size_t pixels_count = width * height;
-    constexpr std::size_t LENGTH_BITS = 32; // first 32 pixels store payload bit length (raw LSB)
-
-    if (pixels_count <= LENGTH_BITS) {
-        throw std::runtime_error("embed_wow: image too small to store length prefix");
-    }
-    const std::size_t available_for_payload = pixels_count - LENGTH_BITS;
-
-    // 1. Extract Y from RGB
-    std::vector<std::uint8_t> Y;
-    encode_y(rgb, Y); // from ycbcr.cpp
-
-    if (Y.size() != pixels_count) {
-        throw std::runtime_error("embed_wow: encode_y produced unexpected Y size");
-    }
-
-    // 2. Build cover symbols = LSBs of Y
-    std::vector<std::uint8_t> cover_symbols;
-    encode_lsb(Y, cover_symbols); // from lsb.cpp
-
-    if (cover_symbols.size() != pixels_count) {
-        throw std::runtime_error("embed_wow: encode_lsb produced unexpected symbol count");
-    }
-
-    // 3. Compute WOW-like rho on Y
-    std::vector<float> Rx, Ry, Rd;
-    _convolve3x3(Y, width, height, Kx, Rx);
-    _convolve3x3(Y, width, height, Ky, Ry);
-    _convolve3x3(Y, width, height, Kd, Rd);
-
-    std::vector<float> rho_f(pixels_count);
-    for (std::size_t i = 0; i < pixels_count; ++i) {
-        float e = std::fabs(Rx[i]) + std::fabs(Ry[i]) + std::fabs(Rd[i]);
-        rho_f[i] = 1.0f / (e + epsilon); // higher activity -> lower cost
-    }
-
-    // 3bis. Build a key-dependent permutation of payload-carrying pixels.
-    std::vector<std::size_t> perm_indices;
-    make_permutation(steg_key, LENGTH_BITS, available_for_payload, perm_indices);
-
-    std::vector<std::uint8_t> price(pixels_count);
-    {
-        float max_rho = 0.0f;
-        for (float r : rho_f) {
-            if (r > max_rho)
-                max_rho = r;
-        }
-
-        const float scale = (max_rho > 0.0f) ? (255.0f / max_rho) : 1.0f;
-        for (std::size_t i = 0; i < pixels_count; ++i) {
-            float v = rho_f[i] * scale;
-            price[i] = _clamp_u8(v);
-        }
-    }
-
-    // 4. Prepare STC input in permuted order.
-    std::vector<std::uint8_t> cover_stc(available_for_payload);
-    std::vector<std::uint8_t> price_stc(available_for_payload);
-
-    for (std::size_t i = 0; i < available_for_payload; ++i) {
-        std::size_t pix_idx = perm_indices[i];
-        cover_stc[i] = cover_symbols[pix_idx];
-        price_stc[i] = price[pix_idx];
-    }
-
-    // 5. Run STC on permuted data.
-    std::vector<std::uint8_t> stego_symbols_stc;
-    encode_stc(
-        cover_stc,
-        payload_bits,
-        price_stc,
-        constraint_height,
-        stego_symbols_stc);
-
-    if (stego_symbols_stc.size() != available_for_payload) {
-        throw std::runtime_error("embed_wow: encode_stc returned wrong symbol count");
-    }
-
-    // 6. Assemble full stego_symbols = [length_bits] + [permuted STC-coded payload bits].
-    std::vector<std::uint8_t> stego_symbols(pixels_count);
-
-    // 6.1 length_bits (same as you had before)
-    std::size_t payload_bit_len = payload_bits.size();
-    std::array<std::uint8_t, LENGTH_BITS> length_bits {};
-    for (std::size_t i = 0; i < LENGTH_BITS; ++i) {
-        std::size_t shift = (LENGTH_BITS - 1) - i; // MSB first
-        length_bits[i] = static_cast<std::uint8_t>((payload_bit_len >> shift) & 0x1u);
-    }
-    for (std::size_t i = 0; i < LENGTH_BITS; ++i) {
-        stego_symbols[i] = length_bits[i];
-    }
-
-    // 6.2 place STC output at permuted positions.
-    for (std::size_t i = 0; i < available_for_payload; ++i) {
-        std::size_t pix_idx = perm_indices[i];
-        stego_symbols[pix_idx] = stego_symbols_stc[i];
-    }
+    bit_vector payload_packed;
+    pack_bits(payload_bits, payload_packed);
+    return embed_wow(rgb, width, height, steg_key, constraint_height, payload_packed, rgb_embedded, cost_embedded);
+}
 
-    // 7. Apply stego LSBs back into Y
-    std::vector<std::uint8_t> Y_stego;
-    decode_lsb(Y, stego_symbols, Y_stego); // from lsb.cpp
+bool embed_wow(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_wow(rgb, width, height, steg_key, constraint_height, payload_bits, embed_options {}, rgb_embedded, cost_embedded);
+}
 
-    // 8. Rebuild RGB with new Y and original chroma
-    return decode_y(rgb, Y_stego, rgb_embedded); // from ycbcr.cpp
+bool embed_wow(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<wow_cost_model>(rgb, width, height, steg_key, constraint_height, payload_bits, options, rgb_embedded, cost_embedded);
 }
 
 // void extract_wow(
@@ -345,75 +176,75 @@ void extract_wow(
     const std::size_t max_payload_bit_count,
     std::vector<std::uint8_t>& payload_bits_out)
 {
-    if (rgb_stego.size() != 3 * width * height) {
-        throw std::runtime_error("extract_wow: rgb_stego.size() must be 3 * width * height");
-    }
-
-    const std::size_t pixels_count = width * height;
-    constexpr std::size_t LENGTH_BITS = 32;
-
-    if (pixels_count <= LENGTH_BITS) {
-        throw std::runtime_error("extract_wow: image too small to contain length prefix");
-    }
-    if (max_payload_bit_count > width * height) {
-        throw std::runtime_error("extract_wow: max_payload_bit_count > number of pixels");
-    }
-    if (max_payload_bit_count == 0) {
-        payload_bits_out.clear();
-        return;
-    }
-
-    const std::size_t available_for_payload = pixels_count - LENGTH_BITS;
-
-    // 1. Extract Y from stego RGB
-    std::vector<std::uint8_t> Y_stego;
-    encode_y(rgb_stego, Y_stego);
-
-    if (Y_stego.size() != pixels_count) {
-        throw std::runtime_error("extract_wow: encode_y produced unexpected Y size");
-    }
-
-    // 2. Extract stego LSB symbols
-    std::vector<std::uint8_t> stego_symbols;
-    encode_lsb(Y_stego, stego_symbols);
+    bit_vector payload_packed;
+    extract_wow(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, payload_packed);
+    unpack_bits(payload_packed, payload_bits_out);
+}
 
-    if (stego_symbols.size() != pixels_count) {
-        throw std::runtime_error("extract_wow: encode_lsb produced unexpected symbol count");
-    }
+void extract_wow(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, payload_bits_out);
+}
 
-    // --- NEW: read 32-bit big-endian payload length from first LENGTH_BITS pixels ---
-    std::size_t payload_bit_len = 0;
-    for (std::size_t i = 0; i < LENGTH_BITS; ++i) {
-        payload_bit_len = (payload_bit_len << 1) | (stego_symbols[i] & 0x1u);
-    }
-    if (payload_bit_len == 0) {
-        // No payload
-        payload_bits_out.clear();
-        return;
-    }
-    if (payload_bit_len > max_payload_bit_count) {
-        throw std::runtime_error("extract_wow: encoded payload length exceeds user cap");
-    }
-    if (payload_bit_len > available_for_payload) {
-        throw std::runtime_error("extract_wow: encoded payload length does not fit in image");
-    }
+bool embed_wow(
+    const std::vector<std::uint8_t>& rgb,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    workspace& memory,
+    std::vector<std::uint8_t>& rgb_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<wow_cost_model>(rgb, width, height, steg_key, constraint_height, payload_bits, options, memory, rgb_embedded, cost_embedded);
+}
 
-    std::vector<std::size_t> perm_indices;
-    make_permutation(steganography_key, LENGTH_BITS, available_for_payload, perm_indices);
+void extract_wow(
+    const std::vector<std::uint8_t>& rgb_stego,
+    const std::size_t width,
+    const std::size_t height,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    workspace& memory,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(rgb_stego, width, height, steganography_key, constraint_height, max_payload_bit_count, options, memory, payload_bits_out);
+}
 
-    // 3) Gather STC input in permuted order.
-    std::vector<std::uint8_t> stc_symbols(available_for_payload);
-    for (std::size_t i = 0; i < available_for_payload; ++i) {
-        std::size_t pix_idx = perm_indices[i];
-        stc_symbols[i] = stego_symbols[pix_idx];
-    }
-    if (stc_symbols.size() != available_for_payload) {
-        throw std::runtime_error("extract_wow: internal STC buffer has wrong size");
-    }
+bool embed_wow(
+    const image_view& image,
+    const std::array<std::uint8_t, 32> steg_key,
+    const std::uint32_t constraint_height,
+    const bit_vector& payload_bits,
+    const embed_options& options,
+    workspace& memory,
+    const mutable_image_view& image_embedded,
+    double& cost_embedded)
+{
+    return embed_luminance<wow_cost_model>(image, steg_key, constraint_height, payload_bits, options, memory, image_embedded, cost_embedded);
+}
 
-    // 4) Decode STC with the known payload_bit_len
-    payload_bits_out.clear();
-    decode_stc(stc_symbols, constraint_height, payload_bit_len, payload_bits_out);
+void extract_wow(
+    const image_view& image_stego,
+    const std::array<std::uint8_t, 32> steganography_key,
+    const std::uint32_t constraint_height,
+    const std::size_t max_payload_bit_count,
+    const extract_options& options,
+    workspace& memory,
+    bit_vector& payload_bits_out)
+{
+    extract_luminance(image_stego, steganography_key, constraint_height, max_payload_bit_count, options, memory, payload_bits_out);
 }
 
 } // namespace binghamton
@@ -0,0 +1,69 @@
+#include <cstring>
+
+#include "gtest_env.hpp"
+#include <binghamton/method/band.hpp>
+#include <binghamton/method/wow.hpp>
+
+namespace binghamton {
+
+TEST_F(binghamton, band_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+    bit_vector _payload;
+    _payload.resize(3000);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 7 + _index / 13) % 3 == 2);
+    }
+    const std::array<std::uint8_t, 32> _steganography_key { 3, 1, 4, 1, 5 };
+
+    // Bands of 40 rows read from the cover and written to the stego image, each row once and in order
+    band_options _bands;
+    _bands.band_height = 40;
+    _bands.halo_rows = 16;
+    const std::size_t _row_bytes = 3 * _width;
+    std::vector<std::uint8_t> _rgb_embedded(_rgb.size());
+    std::size_t _rows_read = 0, _rows_written = 0;
+    const band_reader _read_cover = [&](const std::size_t _first_row, const mutable_image_view& _rows) {
+        EXPECT_EQ(_rows_read, _first_row);
+        std::memcpy(_rows.data, _rgb.data() + _first_row * _row_bytes, _rows.height * _row_bytes);
+        _rows_read += _rows.height;
+    };
+    const band_writer _write_stego = [&](const std::size_t _first_row, const image_view& _rows) {
+        EXPECT_EQ(_rows_written, _first_row);
+        EXPECT_GE(_rows.height, _bands.band_height);
+        std::memcpy(_rgb_embedded.data() + _first_row * _row_bytes, _rows.data, _rows.height * _row_bytes);
+        _rows_written += _rows.height;
+    };
+    workspace _workspace;
+    double _cost;
+    EXPECT_TRUE(embed_bands<wow_cost_model>(_width, _height, _steganography_key, 7, _payload, _bands, embed_options {}, _workspace, _read_cover, _write_stego, _cost));
+    EXPECT_EQ(_height, _rows_read);
+    EXPECT_EQ(_height, _rows_written);
+
+    // The workspace holds a band and its halo rather than the image
+    std::vector<std::uint8_t> _rgb_full;
+    workspace _full_workspace;
+    embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, embed_options {}, _full_workspace, _rgb_full, _cost);
+    EXPECT_LT(2 * _workspace.capacity(), _full_workspace.capacity());
+
+    bit_vector _payload_extracted;
+    const band_reader _read_stego = [&](const std::size_t _first_row, const mutable_image_view& _rows) {
+        std::memcpy(_rows.data, _rgb_embedded.data() + _first_row * _row_bytes, _rows.height * _row_bytes);
+    };
+    extract_bands(_width, _height, _steganography_key, 7, _payload.size, _bands, extract_options {}, _workspace, _read_stego, _payload_extracted);
+    EXPECT_EQ(_payload.size, _payload_extracted.size);
+    EXPECT_EQ(_payload.words, _payload_extracted.words);
+
+    // The cover is rejected from its first band
+    std::size_t _cover_rows_read = 0;
+    const band_reader _read_cover_again = [&](const std::size_t _first_row, const mutable_image_view& _rows) {
+        std::memcpy(_rows.data, _rgb.data() + _first_row * _row_bytes, _rows.height * _row_bytes);
+        _cover_rows_read += _rows.height;
+    };
+    EXPECT_THROW(extract_bands(_width, _height, _steganography_key, 7, _payload.size, _bands, extract_options {}, _workspace, _read_cover_again, _payload_extracted), std::runtime_error);
+    EXPECT_EQ(_bands.band_height, _cover_rows_read);
+}
+
+}
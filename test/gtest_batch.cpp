@@ -0,0 +1,74 @@
+#include "gtest_env.hpp"
+#include <binghamton/method/batch.hpp>
+#include <binghamton/method/hill.hpp>
+
+namespace binghamton {
+
+TEST_F(binghamton, batch_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+
+    // Two covers share a key and a size, one cover has a wrong size and must fail alone
+    std::vector<std::uint8_t> _rgb_brighter(_rgb), _rgb_truncated(_rgb.begin(), _rgb.end() - 3);
+    for (std::uint8_t& _channel : _rgb_brighter) {
+        _channel = _channel < 250 ? _channel + 1 : _channel;
+    }
+    std::vector<bit_vector> _payloads(4);
+    for (std::size_t _job = 0; _job < _payloads.size(); ++_job) {
+        _payloads[_job].resize(300 + 100 * _job);
+        for (std::size_t _index = 0; _index < _payloads[_job].size; ++_index) {
+            _payloads[_job].set(_index, (_index * (_job + 3) + _index / 7) % 5 < 2);
+        }
+    }
+    std::array<std::uint8_t, 32> _first_key {}, _second_key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _first_key[_index] = (std::uint8_t)_index;
+        _second_key[_index] = (std::uint8_t)(255 - _index);
+    }
+    const std::vector<const std::vector<std::uint8_t>*> _covers = { &_rgb, &_rgb_brighter, &_rgb_truncated, &_rgb };
+    const std::vector<std::array<std::uint8_t, 32>> _keys = { _first_key, _first_key, _first_key, _second_key };
+
+    std::vector<embed_job> _embed_jobs(4);
+    for (std::size_t _job = 0; _job < _embed_jobs.size(); ++_job) {
+        _embed_jobs[_job].rgb = _covers[_job];
+        _embed_jobs[_job].width = _width;
+        _embed_jobs[_job].height = _height;
+        _embed_jobs[_job].steg_key = _keys[_job];
+        _embed_jobs[_job].payload_bits = &_payloads[_job];
+    }
+
+    thread_pool _pool(2);
+    permutation_cache _permutations;
+    workspace_pool _workspaces;
+    batch_options _options;
+    _options.pool = &_pool;
+    _options.permutations = &_permutations;
+    _options.workspaces = &_workspaces;
+    std::vector<embed_result> _embed_results;
+    embed_batch<hill_cost_model>(_embed_jobs, 7, _options, _embed_results);
+    ASSERT_EQ(_embed_results.size(), 4u);
+    EXPECT_FALSE(_embed_results[2].error.empty());
+    EXPECT_EQ(_permutations.size(), 2u);
+    EXPECT_GT(_workspaces.capacity(), 0u);
+
+    std::vector<extract_job> _extract_jobs(4);
+    for (std::size_t _job = 0; _job < _extract_jobs.size(); ++_job) {
+        _extract_jobs[_job].rgb_stego = &_embed_results[_job].rgb_embedded;
+        _extract_jobs[_job].width = _width;
+        _extract_jobs[_job].height = _height;
+        _extract_jobs[_job].steg_key = _keys[_job];
+        _extract_jobs[_job].max_payload_bit_count = _payloads[_job].size;
+    }
+    std::vector<extract_result> _extract_results;
+    extract_batch(_extract_jobs, 7, _options, _extract_results);
+    ASSERT_EQ(_extract_results.size(), 4u);
+    EXPECT_FALSE(_extract_results[2].error.empty());
+    for (const std::size_t _job : { 0, 1, 3 }) {
+        EXPECT_TRUE(_embed_results[_job].error.empty()) << _embed_results[_job].error;
+        EXPECT_TRUE(_extract_results[_job].error.empty()) << _extract_results[_job].error;
+        EXPECT_EQ(_payloads[_job].words, _extract_results[_job].payload_bits.words) << "job " << _job;
+    }
+}
+}
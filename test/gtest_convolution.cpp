@@ -0,0 +1,41 @@
+#include <random>
+
+#include "gtest_env.hpp"
+#include <binghamton/method/convolution.hpp>
+
+namespace binghamton {
+
+TEST_F(binghamton, convolution_direct_and_fft)
+{
+    std::mt19937 _generator(1);
+    std::uniform_real_distribution<float> _distribution(-1.0f, 1.0f);
+    constexpr std::size_t _width = 45, _height = 31, _stride = 53;
+
+    for (const std::size_t _taps_count : { 1, 3, 16, 70 }) {
+        std::vector<float> _taps(_taps_count), _input(_stride * (_height + _taps_count));
+        for (float& _tap : _taps) {
+            _tap = _distribution(_generator);
+        }
+        for (float& _sample : _input) {
+            _sample = _distribution(_generator);
+        }
+
+        for (const convolution_method _method : { convolution_method::direct, convolution_method::fft }) {
+            std::vector<float> _rows(_width * _height), _columns(_width * _height);
+            correlate_rows(_input.data(), _stride, _width, _height, _taps, _rows.data(), _width, _method);
+            correlate_columns(_input.data(), _stride, _width, _height, _taps, _columns.data(), _width, _method);
+            for (std::size_t _row = 0; _row < _height; ++_row) {
+                for (std::size_t _column = 0; _column < _width; ++_column) {
+                    double _row_sum = 0.0, _column_sum = 0.0;
+                    for (std::size_t _t = 0; _t < _taps_count; ++_t) {
+                        _row_sum += _taps[_t] * _input[_row * _stride + _column + _t];
+                        _column_sum += _taps[_t] * _input[(_row + _t) * _stride + _column];
+                    }
+                    EXPECT_NEAR(_row_sum, _rows[_row * _width + _column], 1e-4) << "taps=" << _taps_count;
+                    EXPECT_NEAR(_column_sum, _columns[_row * _width + _column], 1e-4) << "taps=" << _taps_count;
+                }
+            }
+        }
+    }
+}
+}
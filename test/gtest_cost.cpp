@@ -0,0 +1,40 @@
+#include <random>
+
+#include "gtest_env.hpp"
+#include <binghamton/method/hill.hpp>
+#include <binghamton/method/suniward.hpp>
+#include <binghamton/method/wow.hpp>
+
+namespace binghamton {
+
+TEST_F(binghamton, cost_tiles_deterministic)
+{
+    // Several tiles with a partial last one, the costs must not depend on the pool
+    constexpr std::size_t _width = 97, _height = 301;
+    std::mt19937 _generator(4);
+    std::vector<std::uint8_t> _y(_width * _height);
+    for (std::uint8_t& _pixel : _y) {
+        _pixel = static_cast<std::uint8_t>(_generator() % 256);
+    }
+
+    thread_pool _pool(3);
+    cost_options _parallel;
+    _parallel.pool = &_pool;
+
+    std::vector<float> _rho, _rho_parallel;
+    cost_wow(_y, _width, _height, _rho);
+    cost_wow(_y, _width, _height, _parallel, _rho_parallel);
+    EXPECT_EQ(_rho, _rho_parallel);
+    cost_suniward(_y, _width, _height, _rho);
+    cost_suniward(_y, _width, _height, _parallel, _rho_parallel);
+    EXPECT_EQ(_rho, _rho_parallel);
+    cost_hill(_y, _width, _height, _rho);
+    cost_hill(_y, _width, _height, _parallel, _rho_parallel);
+    EXPECT_EQ(_rho, _rho_parallel);
+
+    std::vector<std::uint8_t> _price, _price_parallel;
+    price_hill(_y, _width, _height, _price);
+    price_hill(_y, _width, _height, _parallel, _price_parallel);
+    EXPECT_EQ(_price, _price_parallel);
+}
+}
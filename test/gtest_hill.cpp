@@ -0,0 +1,98 @@
+#include <cmath>
+#include <random>
+
+#include "gtest_env.hpp"
+#include <binghamton/method/hill.hpp>
+
+namespace binghamton {
+namespace {
+
+    // Literal evaluation of the HILL cost in double precision: imfilter with symmetric
+    // padding of the KB kernel, then of the 3x3 and 15x15 averaging kernels
+    void make_reference_cost(const std::vector<std::uint8_t>& y, const std::size_t width, const std::size_t height, std::vector<double>& rho)
+    {
+        const auto _mirror = [](std::ptrdiff_t index, std::ptrdiff_t count) {
+            index = ((index % (2 * count)) + 2 * count) % (2 * count);
+            return index < count ? index : 2 * count - 1 - index;
+        };
+        const auto _filter = [&](const std::vector<double>& input, const std::vector<double>& kernel, const std::ptrdiff_t radius, std::vector<double>& output) {
+            const std::ptrdiff_t _span = 2 * radius + 1;
+            output.assign(input.size(), 0.0);
+            for (std::ptrdiff_t _row = 0; _row < static_cast<std::ptrdiff_t>(height); ++_row) {
+                for (std::ptrdiff_t _column = 0; _column < static_cast<std::ptrdiff_t>(width); ++_column) {
+                    double _sum = 0.0;
+                    for (std::ptrdiff_t _k = 0; _k < _span; ++_k) {
+                        for (std::ptrdiff_t _l = 0; _l < _span; ++_l) {
+                            _sum += kernel[_k * _span + _l] * input[_mirror(_row + _k - radius, height) * width + _mirror(_column + _l - radius, width)];
+                        }
+                    }
+                    output[_row * width + _column] = _sum;
+                }
+            }
+        };
+        const std::vector<double> _high_pass = { -1, 2, -1, 2, -4, 2, -1, 2, -1 };
+        const std::vector<double> _average_3(9, 1.0 / 9), _average_15(225, 1.0 / 225);
+        std::vector<double> _y(y.begin(), y.end()), _residual, _smoothed;
+        _filter(_y, _high_pass, 1, _residual);
+        for (double& _value : _residual) {
+            _value = std::fabs(_value);
+        }
+        _filter(_residual, _average_3, 1, _smoothed);
+        for (double& _value : _smoothed) {
+            _value = 1.0 / (_value + 1e-10);
+        }
+        _filter(_smoothed, _average_15, 7, rho);
+        for (double& _value : rho) {
+            _value = _value > 1e10 || std::isnan(_value) ? 1e10 : _value;
+        }
+    }
+
+}
+
+TEST_F(binghamton, hill_cost)
+{
+    std::mt19937 _generator(2);
+    for (const auto& _size : std::vector<std::pair<std::size_t, std::size_t>> { { 1, 1 }, { 5, 3 }, { 41, 23 }, { 19, 290 } }) {
+        for (const std::uint32_t _modulo : { 1u, 3u, 256u }) {
+            std::vector<std::uint8_t> _y(_size.first * _size.second);
+            for (std::uint8_t& _pixel : _y) {
+                _pixel = static_cast<std::uint8_t>(100 + _generator() % _modulo);
+            }
+            std::vector<float> _rho;
+            std::vector<double> _reference_rho;
+            cost_hill(_y, _size.first, _size.second, _rho);
+            make_reference_cost(_y, _size.first, _size.second, _reference_rho);
+            for (std::size_t _index = 0; _index < _rho.size(); ++_index) {
+                EXPECT_NEAR(_reference_rho[_index], _rho[_index], 1e-5 * _reference_rho[_index]) << _size.first << "x" << _size.second << " at " << _index;
+            }
+        }
+    }
+}
+
+TEST_F(binghamton, hill_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+
+    bit_vector _payload;
+    _payload.resize(1000);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 5 + _index / 7) % 3 == 0);
+    }
+
+    std::array<std::uint8_t, 32> _steganography_key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _steganography_key[_index] = (std::uint8_t)(5 * _index + 1);
+    }
+
+    double _cost;
+    std::vector<std::uint8_t> _rgb_embedded;
+    embed_hill(_rgb, _width, _height, _steganography_key, 7, _payload, _rgb_embedded, _cost);
+
+    bit_vector _payload_extracted;
+    extract_hill(_rgb_embedded, _width, _height, _steganography_key, 7, _payload.size, _payload_extracted);
+    EXPECT_EQ(_payload.size, _payload_extracted.size);
+    EXPECT_EQ(_payload.words, _payload_extracted.words);
+}
+}
@@ -0,0 +1,98 @@
+#include <cstdlib>
+
+#include "gtest_env.hpp"
+#include <binghamton/core/ycbcr.hpp>
+#include <binghamton/method/wow.hpp>
+
+namespace binghamton {
+namespace {
+
+    bit_vector _make_payload(const std::size_t bit_count)
+    {
+        bit_vector _payload;
+        _payload.resize(bit_count);
+        for (std::size_t _index = 0; _index < bit_count; ++_index) {
+            _payload.set(_index, (_index * 7 + _index / 3) % 5 < 2);
+        }
+        return _payload;
+    }
+
+}
+
+TEST_F(binghamton, image_view_strided)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+    const bit_vector _payload = _make_payload(1500);
+    const std::array<std::uint8_t, 32> _steganography_key { 1, 2, 3 };
+
+    // The same pixels as BGRA rows padded to a larger stride
+    constexpr std::uint8_t _alpha = 0x5a, _padding = 0xa5;
+    const std::size_t _stride = 4 * _width + 24;
+    std::vector<std::uint8_t> _bgra(_stride * _height, _padding);
+    for (std::size_t _row = 0; _row < _height; ++_row) {
+        for (std::size_t _column = 0; _column < _width; ++_column) {
+            const std::uint8_t* _pixel = _rgb.data() + 3 * (_row * _width + _column);
+            std::uint8_t* _output = _bgra.data() + _row * _stride + 4 * _column;
+            _output[0] = _pixel[2];
+            _output[1] = _pixel[1];
+            _output[2] = _pixel[0];
+            _output[3] = _alpha;
+        }
+    }
+
+    // Embedding through the view gives the pixels of the packed RGB embedding, in place
+    workspace _workspace;
+    std::vector<std::uint8_t> _rgb_embedded;
+    double _cost, _cost_view;
+    ASSERT_TRUE(embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, embed_options {}, _workspace, _rgb_embedded, _cost));
+    const mutable_image_view _image { _bgra.data(), _width, _height, _stride, pixel_layout::bgra };
+    ASSERT_TRUE(embed_wow(_image, _steganography_key, 7, _payload, embed_options {}, _workspace, _image, _cost_view));
+    for (std::size_t _row = 0; _row < _height; ++_row) {
+        for (std::size_t _column = 0; _column < _width; ++_column) {
+            const std::uint8_t* _pixel = _rgb_embedded.data() + 3 * (_row * _width + _column);
+            const std::uint8_t* _output = _bgra.data() + _row * _stride + 4 * _column;
+            ASSERT_EQ(_pixel[0], _output[2]);
+            ASSERT_EQ(_pixel[1], _output[1]);
+            ASSERT_EQ(_pixel[2], _output[0]);
+            ASSERT_EQ(_alpha, _output[3]);
+        }
+        for (std::size_t _byte = 4 * _width; _byte < _stride; ++_byte) {
+            ASSERT_EQ(_padding, _bgra[_row * _stride + _byte]);
+        }
+    }
+
+    bit_vector _payload_extracted;
+    extract_wow(_image, _steganography_key, 7, _payload.size, extract_options {}, _workspace, _payload_extracted);
+    EXPECT_EQ(_payload.words, _payload_extracted.words);
+
+    // A view too narrow for its stride is refused
+    const image_view _invalid { _bgra.data(), _width, _height, 3 * _width, pixel_layout::bgra };
+    EXPECT_THROW(extract_wow(_invalid, _steganography_key, 7, _payload.size, extract_options {}, _workspace, _payload_extracted), std::runtime_error);
+}
+
+TEST_F(binghamton, image_view_gray)
+{
+    std::vector<std::uint8_t> _rgb, _gray;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+    encode_y(_rgb, _gray);
+    const bit_vector _payload = _make_payload(1200);
+    const std::array<std::uint8_t, 32> _steganography_key { 4, 5, 6 };
+
+    // A gray image is its own Y plane, so that each flip moves exactly one byte by one
+    workspace _workspace;
+    std::vector<std::uint8_t> _gray_embedded(_gray.size());
+    double _cost;
+    ASSERT_TRUE(embed_wow(make_image_view(_gray, _width, _height, pixel_layout::gray), _steganography_key, 7, _payload, embed_options {}, _workspace, make_image_view(_gray_embedded, _width, _height, pixel_layout::gray), _cost));
+    for (std::size_t _index = 0; _index < _gray.size(); ++_index) {
+        ASSERT_LE(std::abs(_gray[_index] - _gray_embedded[_index]), 1);
+    }
+
+    bit_vector _payload_extracted;
+    extract_wow(make_image_view(_gray_embedded, _width, _height, pixel_layout::gray), _steganography_key, 7, _payload.size, extract_options {}, _workspace, _payload_extracted);
+    EXPECT_EQ(_payload.words, _payload_extracted.words);
+}
+
+}
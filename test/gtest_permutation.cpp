@@ -0,0 +1,128 @@
+#include <stdexcept>
+#include <vector>
+
+#include "gtest_env.hpp"
+#include <binghamton/core/permutation.hpp>
+#include <binghamton/method/wow.hpp>
+
+namespace binghamton {
+
+TEST_F(binghamton, feistel_permutation)
+{
+    std::array<std::uint8_t, 32> _key {}, _other_key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _key[_index] = (std::uint8_t)(11 * _index + 1);
+        _other_key[_index] = (std::uint8_t)(11 * _index + 2);
+    }
+
+    // Every range size maps onto itself, whatever its distance to a power of four
+    for (const std::size_t _count : { 1, 2, 3, 4, 5, 17, 1000, 4096, 65537 }) {
+        const feistel_permutation _permutation(_key, 32, _count), _other_permutation(_other_key, 32, _count);
+        std::vector<bool> _seen(_count, false);
+        std::size_t _differences_count = 0;
+        for (std::size_t _index = 0; _index < _count; ++_index) {
+            const std::size_t _pixel = _permutation(_index);
+            ASSERT_LE(32u, _pixel);
+            ASSERT_GT(32 + _count, _pixel);
+            EXPECT_FALSE(_seen[_pixel - 32]);
+            _seen[_pixel - 32] = true;
+            _differences_count += _pixel != _other_permutation(_index) ? 1 : 0;
+        }
+        if (_count >= 1000) {
+            EXPECT_LT(_count / 2, _differences_count);
+        }
+    }
+}
+
+TEST_F(binghamton, blocked_permutation)
+{
+    std::array<std::uint8_t, 32> _key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _key[_index] = (std::uint8_t)(13 * _index + 5);
+    }
+
+    // Every range size maps onto itself, the positions of a block staying in one block of pixels
+    // and the blocks being spread over the whole range
+    constexpr std::size_t _block_size = 64;
+    for (const std::size_t _count : { 1, 63, 64, 65, 1000, 4096, 70001 }) {
+        std::vector<std::size_t> _permutation(_count);
+        make_blocked_permutation(_key, 32, _count, _permutation.data(), _block_size);
+        std::vector<bool> _seen(_count, false);
+        std::size_t _moved_blocks_count = 0;
+        for (std::size_t _index = 0; _index < _count; ++_index) {
+            const std::size_t _pixel = _permutation[_index];
+            ASSERT_LE(32u, _pixel);
+            ASSERT_GT(32 + _count, _pixel);
+            EXPECT_FALSE(_seen[_pixel - 32]);
+            _seen[_pixel - 32] = true;
+            EXPECT_EQ((_pixel - 32) / _block_size, (_permutation[_index - _index % _block_size] - 32) / _block_size);
+            _moved_blocks_count += _index % _block_size == 0 && (_pixel - 32) / _block_size != _index / _block_size ? 1 : 0;
+        }
+        if (_count >= 4096) {
+            EXPECT_LT(_count / _block_size / 2, _moved_blocks_count);
+        }
+    }
+
+    // The cache keeps the shuffled and the blocked tables apart
+    permutation_cache _permutations;
+    EXPECT_NE(*_permutations.get(_key, 32, 100000), *_permutations.get(_key, 32, 100000, permutation_version::blocked));
+    EXPECT_EQ(2u, _permutations.size());
+    EXPECT_THROW(_permutations.get(_key, 32, 100000, permutation_version::feistel), std::runtime_error);
+
+    // A bounded cache drops the least recently used table, a holder keeps its own alive
+    permutation_cache _bounded(3 * 1000 * sizeof(std::size_t));
+    const std::shared_ptr<const std::vector<std::size_t>> _first = _bounded.get(_key, 0, 1000);
+    const std::vector<std::size_t> _first_indices = *_first;
+    _bounded.get(_key, 1, 1000);
+    _bounded.get(_key, 2, 1000);
+    _bounded.get(_key, 0, 1000);
+    _bounded.get(_key, 3, 1000);
+    EXPECT_EQ(3u, _bounded.size());
+    EXPECT_EQ(3 * 1000 * sizeof(std::size_t), _bounded.bytes());
+    EXPECT_EQ(_first.get(), _bounded.get(_key, 0, 1000).get());
+    _bounded.get(_key, 4, 1000);
+    _bounded.get(_key, 5, 1000);
+    _bounded.get(_key, 6, 1000);
+    EXPECT_EQ(3u, _bounded.size());
+    EXPECT_EQ(_first_indices, *_first);
+    EXPECT_NE(_first.get(), _bounded.get(_key, 0, 1000).get());
+}
+
+TEST_F(binghamton, keyed_permutation_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+
+    bit_vector _payload;
+    _payload.resize(1200);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 7 + _index / 3) % 5 < 2);
+    }
+    std::array<std::uint8_t, 32> _steganography_key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _steganography_key[_index] = (std::uint8_t)(9 * _index + 4);
+    }
+
+    double _cost;
+    std::vector<std::uint8_t> _rgb_shuffled;
+    embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, embed_options {}, _rgb_shuffled, _cost);
+
+    workspace _workspace;
+    for (const permutation_version _version : { permutation_version::feistel, permutation_version::blocked }) {
+        embed_options _embed_options;
+        _embed_options.permutation = _version;
+        extract_options _extract_options;
+        _extract_options.permutation = _version;
+
+        std::vector<std::uint8_t> _rgb_embedded;
+        embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, _embed_options, _rgb_embedded, _cost);
+        EXPECT_NE(_rgb_embedded, _rgb_shuffled);
+
+        bit_vector _payload_extracted;
+        extract_wow(_rgb_embedded, _width, _height, _steganography_key, 7, _payload.size, _extract_options, _workspace, _payload_extracted);
+        EXPECT_EQ(_payload.size, _payload_extracted.size);
+        EXPECT_EQ(_payload.words, _payload_extracted.words);
+    }
+}
+}
@@ -0,0 +1,54 @@
+#include <cmath>
+
+#include "gtest_env.hpp"
+#include <binghamton/method/simulator.hpp>
+#include <binghamton/method/wow.hpp>
+
+namespace binghamton {
+
+TEST_F(binghamton, gibbs_simulator)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+    prepared_cover _cover;
+    prepare_cover<wow_cost_model>(_rgb, _width, _height, cost_options {}, _cover);
+    const std::size_t _header_span = payload_header_span(make_image_view(_rgb, _width, _height));
+    const std::uint8_t* _price = _cover.price.data() + _header_span;
+    const std::size_t _count = _cover.price.size() - _header_span;
+
+    // Solving for a payload and for its distortion give the same embedding
+    gibbs_embedding _payload_embedding, _distortion_embedding;
+    solve_gibbs_payload(_price, _count, 3000.0, _payload_embedding);
+    EXPECT_NEAR(3000.0, _payload_embedding.payload_bit_count, 1e-3);
+    solve_gibbs_distortion(_price, _count, _payload_embedding.distortion, _distortion_embedding);
+    EXPECT_NEAR(_payload_embedding.lambda, _distortion_embedding.lambda, 1e-6 * _payload_embedding.lambda);
+    EXPECT_EQ(0.0, _payload_embedding.probability[wet_price]);
+    EXPECT_GE(estimate_capacity(_cover, _payload_embedding.distortion) + 1, 3000u);
+    EXPECT_THROW(solve_gibbs_payload(_price, _count, static_cast<double>(_count + 1), _payload_embedding), std::runtime_error);
+
+    // The STC pays at least the optimal distortion, and not much more
+    bit_vector _payload;
+    _payload.resize(3000);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 13 + _index / 5) % 4 < 2);
+    }
+    std::vector<std::uint8_t> _rgb_embedded;
+    double _cost;
+    ASSERT_TRUE(embed_prepared(_cover, std::array<std::uint8_t, 32> {}, 7, _payload, embed_options {}, _rgb_embedded, _cost));
+    EXPECT_LT(_distortion_embedding.distortion, _cost);
+    EXPECT_GT(1.5 * _distortion_embedding.distortion, _cost);
+
+    // The simulation changes about the expected count of pixels, never the header pixels
+    gibbs_embedding _simulated;
+    ASSERT_TRUE(simulate_embedding(_cover, 3000, 1, _rgb_embedded, _simulated));
+    std::size_t _changed_pixels_count = 0;
+    for (std::size_t _index = 0; _index < _width * _height; ++_index) {
+        const bool _changed = !std::equal(_rgb.begin() + 3 * _index, _rgb.begin() + 3 * _index + 3, _rgb_embedded.begin() + 3 * _index);
+        EXPECT_TRUE(_index >= _header_span || !_changed);
+        _changed_pixels_count += _changed ? 1 : 0;
+    }
+    EXPECT_NEAR(_simulated.changed_pixels_count, static_cast<double>(_changed_pixels_count), 5.0 * std::sqrt(_simulated.changed_pixels_count));
+}
+
+}
@@ -0,0 +1,166 @@
+#include <random>
+
+#include "gtest_env.hpp"
+#include <binghamton/core/stc.hpp>
+
+namespace binghamton {
+namespace {
+
+    void make_random_bytes(const std::size_t count, const std::uint32_t seed, const std::uint32_t modulo, std::vector<std::uint8_t>& bytes)
+    {
+        std::mt19937 _generator(seed);
+        bytes.resize(count);
+        for (std::size_t _index = 0; _index < count; ++_index) {
+            bytes[_index] = static_cast<std::uint8_t>(_generator() % modulo);
+        }
+    }
+
+}
+
+TEST_F(binghamton, stc_roundtrip)
+{
+    for (const std::size_t _cover_count : { 1000, 4099 }) {
+        for (const std::size_t _message_count : { 1, 7, 250, 1000 }) {
+            for (std::uint32_t _height = 0; _height <= 12; ++_height) {
+                std::vector<std::uint8_t> _cover, _message, _prices, _stego, _decoded;
+                make_random_bytes(_cover_count, _height + 1, 2, _cover);
+                make_random_bytes(_message_count, _height + 2, 2, _message);
+                make_random_bytes(_cover_count, _height + 3, 256, _prices);
+
+                const double _distortion = encode_stc(_cover, _message, _prices, _height, _stego);
+                decode_stc(_stego, _height, _message.size(), _decoded);
+                EXPECT_EQ(_message, _decoded) << "n=" << _cover_count << " m=" << _message_count << " h=" << _height;
+
+                double _expected_distortion = 0.0;
+                for (std::size_t _index = 0; _index < _cover_count; ++_index) {
+                    if (_cover[_index] != _stego[_index]) {
+                        _expected_distortion += _prices[_index];
+                    }
+                }
+                EXPECT_EQ(_expected_distortion, _distortion);
+            }
+        }
+    }
+}
+
+TEST_F(binghamton, stc_distortion_below_parity)
+{
+    std::vector<std::uint8_t> _cover, _message, _prices, _stego;
+    make_random_bytes(1 << 14, 1, 2, _cover);
+    make_random_bytes(1 << 12, 2, 2, _message);
+    make_random_bytes(1 << 14, 3, 256, _prices);
+
+    const double _parity_distortion = encode_stc(_cover, _message, _prices, 0, _stego);
+    const double _trellis_distortion = encode_stc(_cover, _message, _prices, 7, _stego);
+    EXPECT_LT(_trellis_distortion, _parity_distortion);
+}
+
+TEST_F(binghamton, stc_bounded_memory)
+{
+    std::vector<std::uint8_t> _cover, _message, _prices, _stego, _stego_bounded, _decoded;
+    make_random_bytes(20000, 1, 2, _cover);
+    make_random_bytes(5003, 2, 2, _message);
+    make_random_bytes(20000, 3, 256, _prices);
+
+    for (const std::uint32_t _height : { 1u, 5u, 9u }) {
+        const double _distortion = encode_stc(_cover, _message, _prices, _height, _stego);
+        const std::size_t _full_path_memory = _cover.size() * ((std::size_t(1) << _height) + 7) / 8;
+        for (const std::size_t _path_memory_divisor : { 2, 5, 12 }) {
+            const std::size_t _path_memory_limit = _full_path_memory / _path_memory_divisor;
+            stc_options _options;
+            _options.path_memory_limit = _path_memory_limit;
+            const double _distortion_bounded = encode_stc(_cover, _message, _prices, _height, _options, _stego_bounded);
+            EXPECT_EQ(_stego, _stego_bounded) << "h=" << _height << " limit=" << _path_memory_limit;
+            EXPECT_EQ(_distortion, _distortion_bounded);
+        }
+    }
+
+    stc_options _options;
+    _options.path_memory_limit = 16;
+    EXPECT_THROW(encode_stc(_cover, _message, _prices, 9, _options, _stego_bounded), std::runtime_error);
+}
+
+TEST_F(binghamton, stc_segmented)
+{
+    std::vector<std::uint8_t> _cover, _message, _prices, _stego, _stego_parallel, _decoded;
+    make_random_bytes(30011, 1, 2, _cover);
+    make_random_bytes(7001, 2, 2, _message);
+    make_random_bytes(30011, 3, 256, _prices);
+
+    thread_pool _pool(3);
+    for (const std::uint32_t _height : { 0u, 4u, 8u }) {
+        for (const std::size_t _segment_count : { 1, 2, 7 }) {
+            stc_options _options;
+            _options.segment_count = _segment_count;
+            const double _distortion = encode_stc(_cover, _message, _prices, _height, _options, _stego);
+            decode_stc(_stego, _height, _message.size(), _options, _decoded);
+            EXPECT_EQ(_message, _decoded) << "h=" << _height << " segments=" << _segment_count;
+
+            _options.pool = &_pool;
+            const double _distortion_parallel = encode_stc(_cover, _message, _prices, _height, _options, _stego_parallel);
+            EXPECT_EQ(_stego, _stego_parallel);
+            EXPECT_EQ(_distortion, _distortion_parallel);
+            decode_stc(_stego_parallel, _height, _message.size(), _options, _decoded);
+            EXPECT_EQ(_message, _decoded);
+        }
+    }
+}
+
+TEST_F(binghamton, stc_packed)
+{
+    for (const std::size_t _cover_count : { 1000, 4099 }) {
+        for (const std::size_t _message_count : { 1, 13, 250, 1000 }) {
+            for (const std::uint32_t _height : { 0u, 1u, 6u, 11u }) {
+                for (const std::size_t _segment_count : { 1, 3 }) {
+                    std::vector<std::uint8_t> _cover, _message, _prices, _stego, _decoded, _unpacked;
+                    make_random_bytes(_cover_count, _height + 1, 2, _cover);
+                    make_random_bytes(_message_count, _height + 2, 2, _message);
+                    make_random_bytes(_cover_count, _height + 3, 256, _prices);
+
+                    stc_options _options;
+                    _options.segment_count = _segment_count;
+                    bit_vector _cover_packed, _message_packed, _stego_packed, _decoded_packed;
+                    pack_bits(_cover, _cover_packed);
+                    pack_bits(_message, _message_packed);
+                    const double _distortion = encode_stc(_cover, _message, _prices, _height, _options, _stego);
+                    const double _distortion_packed = encode_stc(_cover_packed, _message_packed, _prices, _height, _options, _stego_packed);
+                    unpack_bits(_stego_packed, _unpacked);
+                    EXPECT_EQ(_stego, _unpacked) << "n=" << _cover_count << " m=" << _message_count << " h=" << _height;
+                    EXPECT_EQ(_distortion, _distortion_packed);
+
+                    decode_stc(_stego_packed, _height, _message_count, _options, _decoded_packed);
+                    unpack_bits(_decoded_packed, _decoded);
+                    EXPECT_EQ(_message, _decoded);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(binghamton, stc_wet_symbols)
+{
+    // A quarter of the symbols is wet, the others carry the message without touching them
+    constexpr std::size_t _cover_count = 4099;
+    for (const std::uint32_t _height : { 0u, 4u, 9u }) {
+        std::vector<std::uint8_t> _cover, _message, _prices, _wetness, _stego, _decoded;
+        make_random_bytes(_cover_count, _height + 1, 2, _cover);
+        make_random_bytes(_cover_count / 8, _height + 2, 2, _message);
+        make_random_bytes(_cover_count, _height + 3, wet_price, _prices);
+        make_random_bytes(_cover_count, _height + 4, 4, _wetness);
+        for (std::size_t _index = 0; _index < _cover_count; ++_index) {
+            _prices[_index] = _wetness[_index] == 0 ? wet_price : _prices[_index];
+        }
+
+        stc_options _options;
+        _options.wet_symbols = true;
+        encode_stc(_cover, _message, _prices, _height, _options, _stego);
+        decode_stc(_stego, _height, _message.size(), _decoded);
+        EXPECT_EQ(_message, _decoded) << "h=" << _height;
+        for (std::size_t _index = 0; _index < _cover_count; ++_index) {
+            if (_prices[_index] == wet_price) {
+                EXPECT_EQ(_cover[_index], _stego[_index]) << "h=" << _height << " index=" << _index;
+            }
+        }
+    }
+}
+}
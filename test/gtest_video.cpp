@@ -0,0 +1,90 @@
+#include <algorithm>
+
+#include "gtest_env.hpp"
+#include <binghamton/core/ycbcr.hpp>
+#include <binghamton/method/video.hpp>
+#include <binghamton/method/wow.hpp>
+
+namespace binghamton {
+
+TEST_F(binghamton, yuv420_sequence_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb, _y;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+    encode_y(_rgb, _y);
+    const std::array<std::uint8_t, 32> _steganography_key { 9, 8, 7 };
+
+    // Frames of the same luma shifted by a few columns, with padded luma rows and constant chroma
+    constexpr std::size_t _frames_count = 6, _frame_bit_count = 1500;
+    constexpr std::uint8_t _padding = 0xa5, _chroma = 0x80;
+    const std::size_t _y_stride = _width + 16, _uv_stride = (_width + 1) / 2;
+    const std::size_t _uv_size = _uv_stride * ((_height + 1) / 2);
+    std::vector<std::vector<std::uint8_t>> _planes(3 * _frames_count);
+    std::vector<yuv420_frame> _frames(_frames_count);
+    for (std::size_t _frame = 0; _frame < _frames_count; ++_frame) {
+        std::vector<std::uint8_t>& _luma = _planes[3 * _frame];
+        _luma.assign(_y_stride * _height, _padding);
+        for (std::size_t _row = 0; _row < _height; ++_row) {
+            for (std::size_t _column = 0; _column < _width; ++_column) {
+                _luma[_row * _y_stride + _column] = _y[_row * _width + (_column + 3 * _frame) % _width];
+            }
+        }
+        _planes[3 * _frame + 1].assign(_uv_size, _chroma);
+        _planes[3 * _frame + 2].assign(_uv_size, _chroma);
+        _frames[_frame] = yuv420_frame { _luma.data(), _planes[3 * _frame + 1].data(), _planes[3 * _frame + 2].data(), _width, _height, _y_stride, _uv_stride };
+    }
+    const std::vector<std::vector<std::uint8_t>> _cover_planes = _planes;
+
+    // Frames 0 to 2 carry 1500, 1500 and 1200 bits, frames 3 to 5 stay the cover frames
+    bit_vector _payload;
+    _payload.resize(4200);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 5 + _index / 7) % 3 == 0);
+    }
+    sequence_embedder _embedder(_steganography_key, 7, _payload, _frame_bit_count);
+    double _cost;
+    for (const yuv420_frame& _frame : _frames) {
+        EXPECT_TRUE(_embedder.embed_frame<wow_cost_model>(_frame, _cost));
+    }
+    EXPECT_TRUE(_embedder.finished());
+    EXPECT_EQ(_payload.size, _embedder.embedded_bit_count());
+    for (std::size_t _frame = 0; _frame < _frames_count; ++_frame) {
+        EXPECT_EQ(_cover_planes[3 * _frame + 1], _planes[3 * _frame + 1]);
+        EXPECT_EQ(_cover_planes[3 * _frame + 2], _planes[3 * _frame + 2]);
+        EXPECT_EQ(_frame >= 3, _cover_planes[3 * _frame] == _planes[3 * _frame]);
+        for (std::size_t _row = 0; _row < _height; ++_row) {
+            for (std::size_t _byte = _width; _byte < _y_stride; ++_byte) {
+                ASSERT_EQ(_padding, _planes[3 * _frame][_row * _y_stride + _byte]);
+            }
+        }
+    }
+
+    sequence_extractor _extractor(_steganography_key, 7, _frame_bit_count, _payload.size);
+    for (std::size_t _frame = 0; _frame < _frames_count; ++_frame) {
+        EXPECT_EQ(_frame >= 3, _extractor.finished());
+        _extractor.extract_frame(_frames[_frame]);
+    }
+    EXPECT_TRUE(_extractor.finished());
+    EXPECT_EQ(_payload.size, _extractor.payload_bits().size);
+    EXPECT_EQ(_payload.words, _extractor.payload_bits().words);
+
+    // A payload of whole frames ends with a frame carrying no bits
+    // The planes are copied back in place, _frames points into them
+    for (std::size_t _plane = 0; _plane < _planes.size(); ++_plane) {
+        std::copy(_cover_planes[_plane].begin(), _cover_planes[_plane].end(), _planes[_plane].begin());
+    }
+    _payload.resize(2 * _frame_bit_count);
+    sequence_embedder _whole_embedder(_steganography_key, 7, _payload, _frame_bit_count);
+    sequence_extractor _whole_extractor(_steganography_key, 7, _frame_bit_count, _payload.size);
+    for (std::size_t _frame = 0; _frame < 3; ++_frame) {
+        EXPECT_FALSE(_whole_embedder.finished());
+        EXPECT_TRUE(_whole_embedder.embed_frame<wow_cost_model>(_frames[_frame], _cost));
+        _whole_extractor.extract_frame(_frames[_frame]);
+    }
+    EXPECT_TRUE(_whole_embedder.finished());
+    EXPECT_TRUE(_whole_extractor.finished());
+    EXPECT_EQ(_payload.words, _whole_extractor.payload_bits().words);
+}
+
+}
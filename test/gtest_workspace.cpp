@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+#include "gtest_env.hpp"
+#include <binghamton/method/wow.hpp>
+
+// The heap allocations are counted while a test measures them, whatever the thread. Plain
+// allocations go to malloc as usual, over-aligned ones are aligned by hand within a larger
+// block whose address is stored before them, so that the aligned delete frees that block.
+namespace {
+std::atomic<bool> _heap_allocations_counted { false };
+std::atomic<std::size_t> _heap_allocations_count { 0 };
+
+void _count_allocation()
+{
+    if (_heap_allocations_counted) {
+        ++_heap_allocations_count;
+    }
+}
+
+void* _allocate(std::size_t size)
+{
+    _count_allocation();
+    void* _pointer = std::malloc(std::max<std::size_t>(size, 1));
+    if (_pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return _pointer;
+}
+
+void* _allocate_aligned(std::size_t size, std::size_t alignment)
+{
+    _count_allocation();
+    void* _block = std::malloc(size + alignment + sizeof(void*));
+    if (_block == nullptr) {
+        throw std::bad_alloc();
+    }
+    const std::uintptr_t _address = (reinterpret_cast<std::uintptr_t>(_block) + sizeof(void*) + alignment - 1) / alignment * alignment;
+    void* _pointer = reinterpret_cast<void*>(_address);
+    static_cast<void**>(_pointer)[-1] = _block;
+    return _pointer;
+}
+
+void _free_aligned(void* pointer)
+{
+    if (pointer != nullptr) {
+        std::free(static_cast<void**>(pointer)[-1]);
+    }
+}
+}
+
+void* operator new(std::size_t size)
+{
+    return _allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return _allocate_aligned(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    _free_aligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    _free_aligned(pointer);
+}
+
+namespace binghamton {
+namespace {
+
+    // Memory resource counting the allocations it forwards to the heap
+    struct counting_resource : public std::pmr::memory_resource {
+        std::size_t allocations_count = 0;
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++allocations_count;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+}
+
+TEST_F(binghamton, workspace_allocations)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+
+    std::vector<bit_vector> _payloads(2);
+    for (std::size_t _round = 0; _round < _payloads.size(); ++_round) {
+        _payloads[_round].resize(1500);
+        for (std::size_t _index = 0; _index < _payloads[_round].size; ++_index) {
+            _payloads[_round].set(_index, (_index * (_round + 3) + _index / 5) % 3 == 0);
+        }
+    }
+    std::array<std::uint8_t, 32> _steganography_key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _steganography_key[_index] = (std::uint8_t)(3 * _index + 7);
+    }
+
+    // The first round warms the workspace and the outputs up, the second round must
+    // allocate nothing, neither from the workspace resource nor from the heap
+    counting_resource _resource;
+    workspace _workspace(&_resource);
+    std::vector<std::uint8_t> _rgb_embedded;
+    bit_vector _payload_extracted;
+    double _cost;
+    std::size_t _resource_allocations_count = 0, _heap_allocations_before = 0;
+    for (std::size_t _round = 0; _round < _payloads.size(); ++_round) {
+        _resource_allocations_count = _resource.allocations_count;
+        _heap_allocations_before = _heap_allocations_count;
+        _heap_allocations_counted = true;
+        const bool _embedded = embed_wow(_rgb, _width, _height, _steganography_key, 7, _payloads[_round], embed_options {}, _workspace, _rgb_embedded, _cost);
+        extract_wow(_rgb_embedded, _width, _height, _steganography_key, 7, _payloads[_round].size, extract_options {}, _workspace, _payload_extracted);
+        _heap_allocations_counted = false;
+        const std::size_t _heap_allocations_after = _heap_allocations_count;
+
+        EXPECT_TRUE(_embedded);
+        EXPECT_EQ(_payloads[_round].size, _payload_extracted.size);
+        EXPECT_EQ(_payloads[_round].words, _payload_extracted.words);
+        if (_round == 0) {
+            EXPECT_LT(_resource_allocations_count, _resource.allocations_count);
+        } else {
+            EXPECT_EQ(_resource_allocations_count, _resource.allocations_count);
+            EXPECT_EQ(_heap_allocations_before, _heap_allocations_after);
+        }
+    }
+    EXPECT_LT(0u, _workspace.capacity());
+}
+}
@@ -1,7 +1,130 @@
+#include <cmath>
+#include <random>
+
 #include "gtest_env.hpp"
+#include <binghamton/method/suniward.hpp>
 #include <binghamton/method/wow.hpp>
 
 namespace binghamton {
+namespace {
+
+    // Literal evaluation of the WOW or S-UNIWARD cost in double precision: symmetric padding,
+    // full 16x16 conv2 'same' of the residual and of its suitability, shift and crop, then
+    // p = -1 for WOW or the sum for S-UNIWARD
+    void make_reference_cost(const std::vector<std::uint8_t>& y, const std::size_t width, const std::size_t height, const bool uniward, std::vector<double>& rho)
+    {
+        const std::vector<double> _high_pass = {
+            -0.0544158422, 0.3128715909, -0.6756307363, 0.5853546837, 0.0158291053, -0.2840155430, -0.0004724846, 0.1287474266,
+            0.0173693010, -0.0440882539, -0.0139810279, 0.0087460940, 0.0048703530, -0.0003917404, -0.0006754494, -0.0001174768
+        };
+        std::vector<double> _low_pass(16);
+        for (std::size_t _index = 0; _index < 16; ++_index) {
+            _low_pass[_index] = (_index % 2 == 0 ? 1.0 : -1.0) * _high_pass[15 - _index];
+        }
+        const auto _mirror = [](std::ptrdiff_t index, std::ptrdiff_t count) {
+            index = ((index % (2 * count)) + 2 * count) % (2 * count);
+            return index < count ? index : 2 * count - 1 - index;
+        };
+        const std::ptrdiff_t _padded_width = width + 32, _padded_height = height + 32;
+        std::vector<double> _padded(_padded_width * _padded_height);
+        for (std::ptrdiff_t _row = 0; _row < _padded_height; ++_row) {
+            for (std::ptrdiff_t _column = 0; _column < _padded_width; ++_column) {
+                _padded[_row * _padded_width + _column] = y[_mirror(_row - 16, height) * width + _mirror(_column - 16, width)];
+            }
+        }
+        // conv2(input, kernel, 'same') for a 16x16 kernel, zero outside the input
+        const auto _convolve_same = [&](const std::vector<double>& input, const std::vector<double>& kernel, std::vector<double>& output) {
+            output.assign(input.size(), 0.0);
+            for (std::ptrdiff_t _row = 0; _row < _padded_height; ++_row) {
+                for (std::ptrdiff_t _column = 0; _column < _padded_width; ++_column) {
+                    double _sum = 0.0;
+                    for (std::ptrdiff_t _k = 0; _k < 16; ++_k) {
+                        for (std::ptrdiff_t _l = 0; _l < 16; ++_l) {
+                            const std::ptrdiff_t _source_row = _row + 8 - _k, _source_column = _column + 8 - _l;
+                            if (_source_row >= 0 && _source_row < _padded_height && _source_column >= 0 && _source_column < _padded_width) {
+                                _sum += kernel[_k * 16 + _l] * input[_source_row * _padded_width + _source_column];
+                            }
+                        }
+                    }
+                    output[_row * _padded_width + _column] = _sum;
+                }
+            }
+        };
+        const std::vector<double>* _filters[3][2] = { { &_low_pass, &_high_pass }, { &_high_pass, &_low_pass }, { &_high_pass, &_high_pass } };
+        rho.assign(width * height, 0.0);
+        for (const auto& _filter : _filters) {
+            std::vector<double> _kernel(256), _rotated_absolute(256), _residual, _suitability;
+            for (std::size_t _k = 0; _k < 16; ++_k) {
+                for (std::size_t _l = 0; _l < 16; ++_l) {
+                    _kernel[_k * 16 + _l] = (*_filter[0])[_k] * (*_filter[1])[_l];
+                    _rotated_absolute[(15 - _k) * 16 + (15 - _l)] = std::fabs(_kernel[_k * 16 + _l]);
+                }
+            }
+            _convolve_same(_padded, _kernel, _residual);
+            for (double& _value : _residual) {
+                _value = uniward ? 1.0 / (std::fabs(_value) + 1.0) : std::fabs(_value);
+            }
+            _convolve_same(_residual, _rotated_absolute, _suitability);
+            for (std::size_t _row = 0; _row < height; ++_row) {
+                for (std::size_t _column = 0; _column < width; ++_column) {
+                    // circshift by one row and one column, then crop the padding
+                    const double _xi = _suitability[(_row + 15) * _padded_width + _column + 15];
+                    rho[_row * width + _column] += uniward ? _xi : 1.0 / _xi;
+                }
+            }
+        }
+        for (double& _value : rho) {
+            _value = _value > 1e10 || std::isnan(_value) ? 1e10 : _value;
+        }
+    }
+
+}
+
+TEST_F(binghamton, wow_cost)
+{
+    std::mt19937 _generator(1);
+    for (const auto& _size : std::vector<std::pair<std::size_t, std::size_t>> { { 1, 1 }, { 5, 3 }, { 37, 29 } }) {
+        for (const std::uint32_t _modulo : { 1u, 4u, 256u }) {
+            std::vector<std::uint8_t> _y(_size.first * _size.second);
+            for (std::uint8_t& _pixel : _y) {
+                _pixel = static_cast<std::uint8_t>(100 + _generator() % _modulo);
+            }
+            std::vector<float> _rho;
+            std::vector<double> _reference_rho;
+            cost_wow(_y, _size.first, _size.second, _rho);
+            make_reference_cost(_y, _size.first, _size.second, false, _reference_rho);
+            for (std::size_t _index = 0; _index < _rho.size(); ++_index) {
+                if (_reference_rho[_index] < 1.0) {
+                    EXPECT_NEAR(_reference_rho[_index], _rho[_index], 1e-3 * _reference_rho[_index]) << _size.first << "x" << _size.second << " at " << _index;
+                } else {
+                    // flat areas leave a suitability made of rounding errors only
+                    EXPECT_GE(_rho[_index], 1.0f) << _size.first << "x" << _size.second << " at " << _index;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(binghamton, suniward_cost)
+{
+    std::mt19937 _generator(3);
+    for (const auto& _size : std::vector<std::pair<std::size_t, std::size_t>> { { 1, 1 }, { 5, 3 }, { 37, 29 } }) {
+        for (const std::uint32_t _modulo : { 1u, 4u, 256u }) {
+            std::vector<std::uint8_t> _y(_size.first * _size.second);
+            for (std::uint8_t& _pixel : _y) {
+                _pixel = static_cast<std::uint8_t>(100 + _generator() % _modulo);
+            }
+            std::vector<float> _rho;
+            std::vector<double> _reference_rho;
+            cost_suniward(_y, _size.first, _size.second, _rho);
+            make_reference_cost(_y, _size.first, _size.second, true, _reference_rho);
+            for (std::size_t _index = 0; _index < _rho.size(); ++_index) {
+                EXPECT_NEAR(_reference_rho[_index], _rho[_index], 1e-4 * _reference_rho[_index]) << _size.first << "x" << _size.second << " at " << _index;
+            }
+        }
+    }
+}
+
 TEST_F(binghamton, wow_roundtrip)
 {
     std::vector<std::uint8_t> _rgb;
@@ -33,4 +156,229 @@ TEST_F(binghamton, wow_roundtrip)
     extract_wow(_rgb_verify, _width_verify, _height_verify, _steganography_key, 3, _payload.size(), _payload_extracted);
     EXPECT_EQ(_payload, _payload_extracted);
 }
-}
\ No newline at end of file
+
+TEST_F(binghamton, wow_packed_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+
+    bit_vector _payload;
+    _payload.resize(1000);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 7 + _index / 3) % 5 < 2);
+    }
+
+    std::array<std::uint8_t, 32> _steganography_key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _steganography_key[_index] = (std::uint8_t)(3 * _index);
+    }
+
+    double _cost;
+    std::vector<std::uint8_t> _rgb_embedded;
+    embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, _rgb_embedded, _cost);
+
+    bit_vector _payload_extracted;
+    extract_wow(_rgb_embedded, _width, _height, _steganography_key, 7, _payload.size, _payload_extracted);
+    EXPECT_EQ(_payload.size, _payload_extracted.size);
+    EXPECT_EQ(_payload.words, _payload_extracted.words);
+}
+
+TEST_F(binghamton, suniward_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+
+    bit_vector _payload;
+    _payload.resize(1000);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 3 + _index / 5) % 4 == 1);
+    }
+
+    std::array<std::uint8_t, 32> _steganography_key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _steganography_key[_index] = (std::uint8_t)(7 * _index + 2);
+    }
+
+    double _cost;
+    std::vector<std::uint8_t> _rgb_embedded;
+    embed_suniward(_rgb, _width, _height, _steganography_key, 7, _payload, _rgb_embedded, _cost);
+
+    bit_vector _payload_extracted;
+    extract_suniward(_rgb_embedded, _width, _height, _steganography_key, 7, _payload.size, _payload_extracted);
+    EXPECT_EQ(_payload.size, _payload_extracted.size);
+    EXPECT_EQ(_payload.words, _payload_extracted.words);
+}
+
+TEST_F(binghamton, wow_prepared_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+
+    prepared_cover _cover;
+    prepare_cover<wow_cost_model>(_rgb, _width, _height, cost_options {}, _cover);
+
+    // Many payloads under many keys in the same prepared cover, each stego image being the one of embed_wow
+    workspace _workspace;
+    for (std::size_t _round = 0; _round < 3; ++_round) {
+        bit_vector _payload;
+        _payload.resize(800 + 200 * _round);
+        for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+            _payload.set(_index, (_index * (_round + 2) + _index / 7) % 3 == 0);
+        }
+        std::array<std::uint8_t, 32> _steganography_key {};
+        for (std::size_t _index = 0; _index < 32; ++_index) {
+            _steganography_key[_index] = (std::uint8_t)(5 * _index + _round);
+        }
+
+        double _cost;
+        std::vector<std::uint8_t> _rgb_embedded, _rgb_prepared_embedded;
+        embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, _rgb_embedded, _cost);
+        embed_prepared(_cover, _steganography_key, 7, _payload, embed_options {}, _workspace, _rgb_prepared_embedded, _cost);
+        EXPECT_EQ(_rgb_embedded, _rgb_prepared_embedded);
+
+        bit_vector _payload_extracted;
+        extract_wow(_rgb_prepared_embedded, _width, _height, _steganography_key, 7, _payload.size, _payload_extracted);
+        EXPECT_EQ(_payload.words, _payload_extracted.words);
+    }
+}
+
+TEST_F(binghamton, wow_saturated_roundtrip)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+
+    // Every third pixel saturated, the header pixels included: black, white, clipping both ways or
+    // clipping one way only
+    const std::array<std::array<std::uint8_t, 3>, 4> _saturated = { { { 0, 0, 0 }, { 255, 255, 255 }, { 0, 255, 128 }, { 0, 1, 200 } } };
+    for (std::size_t _index = 0; _index < _width * _height; _index += 3) {
+        const std::array<std::uint8_t, 3>& _pixel = _saturated[(_index / 3) % _saturated.size()];
+        std::copy(_pixel.begin(), _pixel.end(), _rgb.begin() + 3 * _index);
+    }
+
+    bit_vector _payload;
+    _payload.resize(2000);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 5 + _index / 9) % 3 == 1);
+    }
+    std::array<std::uint8_t, 32> _steganography_key {};
+    for (std::size_t _index = 0; _index < 32; ++_index) {
+        _steganography_key[_index] = (std::uint8_t)(17 * _index + 3);
+    }
+
+    double _cost;
+    std::vector<std::uint8_t> _rgb_embedded;
+    EXPECT_TRUE(embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, _rgb_embedded, _cost));
+    for (std::size_t _index = 6; _index < _width * _height; _index += 12) {
+        EXPECT_TRUE(std::equal(_rgb.begin() + 3 * _index, _rgb.begin() + 3 * _index + 3, _rgb_embedded.begin() + 3 * _index));
+    }
+
+    bit_vector _payload_extracted;
+    extract_wow(_rgb_embedded, _width, _height, _steganography_key, 7, _payload.size, _payload_extracted);
+    EXPECT_EQ(_payload.words, _payload_extracted.words);
+}
+
+TEST_F(binghamton, payload_header)
+{
+    // The CRC-32 check value of "123456789"
+    bit_vector _check;
+    _check.resize(72);
+    _check.words = { 0x3837363534333231u, 0x39u };
+    EXPECT_EQ(0xcbf43926u, crc32(_check));
+
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+    bit_vector _payload;
+    _payload.resize(1000);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 3 + _index / 11) % 4 == 0);
+    }
+    const std::array<std::uint8_t, 32> _steganography_key { 5, 4, 3 };
+
+    // A cover image carries no header
+    bit_vector _payload_extracted;
+    EXPECT_THROW(extract_wow(_rgb, _width, _height, _steganography_key, 7, _payload.size, _payload_extracted), std::runtime_error);
+
+    double _cost;
+    std::vector<std::uint8_t> _rgb_embedded;
+    ASSERT_TRUE(embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, _rgb_embedded, _cost));
+    extract_wow(_rgb_embedded, _width, _height, _steganography_key, 7, _payload.size, _payload_extracted);
+    EXPECT_EQ(_payload.words, _payload_extracted.words);
+
+    // The header records the permutation, and the checksum catches a wrong key
+    extract_options _feistel;
+    _feistel.permutation = permutation_version::feistel;
+    workspace _workspace;
+    EXPECT_THROW(extract_wow(_rgb_embedded, _width, _height, _steganography_key, 7, _payload.size, _feistel, _workspace, _payload_extracted), std::runtime_error);
+    const std::array<std::uint8_t, 32> _other_key { 5, 4, 2 };
+    EXPECT_THROW(extract_wow(_rgb_embedded, _width, _height, _other_key, 7, _payload.size, _payload_extracted), std::runtime_error);
+
+    // The header is masked by the key, the same payload in the same cover gives other header bits under
+    // another key, none of them holding the magic number in the clear
+    std::vector<std::uint8_t> _rgb_other_key;
+    ASSERT_TRUE(embed_wow(_rgb, _width, _height, _other_key, 7, _payload, _rgb_other_key, _cost));
+    std::array<std::size_t, payload_header_bits> _header_pixels;
+    ASSERT_EQ(payload_header_bits, find_unclipped_pixels(make_image_view(_rgb, _width, _height), payload_header_bits, _header_pixels.data()));
+    bit_vector _lsb, _other_lsb, _header, _other_header;
+    encode_y_lsb(make_image_view(_rgb_embedded, _width, _height), _lsb);
+    encode_y_lsb(make_image_view(_rgb_other_key, _width, _height), _other_lsb);
+    _header.resize(payload_header_bits);
+    _other_header.resize(payload_header_bits);
+    for (std::size_t _index = 0; _index < payload_header_bits; ++_index) {
+        _header.set(_index, _lsb.get(_header_pixels[_index]));
+        _other_header.set(_index, _other_lsb.get(_header_pixels[_index]));
+    }
+    EXPECT_NE(_header.words, _other_header.words);
+    std::uint64_t _magic = 0;
+    for (std::size_t _index = 0; _index < 16; ++_index) {
+        _magic = (_magic << 1) | (_header.get(_index) ? 1u : 0u);
+    }
+    EXPECT_NE(0xb16eu, _magic);
+}
+
+TEST_F(binghamton, embed_stats)
+{
+    std::vector<std::uint8_t> _rgb;
+    std::size_t _width, _height;
+    load_default_image(_rgb, _width, _height);
+    bit_vector _payload;
+    _payload.resize(2000);
+    for (std::size_t _index = 0; _index < _payload.size; ++_index) {
+        _payload.set(_index, (_index * 11 + _index / 3) % 5 < 2);
+    }
+    const std::array<std::uint8_t, 32> _steganography_key { 2, 7, 1, 8 };
+
+    embed_stats _stats;
+    embed_options _options;
+    _options.stats = &_stats;
+    workspace _workspace;
+    std::vector<std::uint8_t> _rgb_embedded;
+    double _cost = 0.0;
+    ASSERT_TRUE(embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, _options, _workspace, _rgb_embedded, _cost));
+
+    // Every changed pixel is counted, and the STC codes more than one bit per change
+    std::size_t _changed_pixels_count = 0;
+    for (std::size_t _index = 0; _index < _width * _height; ++_index) {
+        _changed_pixels_count += std::equal(_rgb.begin() + 3 * _index, _rgb.begin() + 3 * _index + 3, _rgb_embedded.begin() + 3 * _index) ? 0 : 1;
+    }
+    EXPECT_EQ(_changed_pixels_count, _stats.changed_pixels_count);
+    EXPECT_EQ(_payload.size, _stats.payload_bit_count);
+    EXPECT_LT(0.0, _cost);
+    EXPECT_EQ(_cost, _stats.distortion);
+    EXPECT_LT(1.0, _stats.efficiency());
+    EXPECT_LT(0.0, _stats.stage_seconds[static_cast<std::size_t>(embed_stage::cost)]);
+    EXPECT_LT(0u, _stats.allocated_bytes);
+    EXPECT_EQ(_workspace.capacity(), _stats.peak_workspace_bytes);
+
+    // A warm workspace allocates nothing, and the stats add up
+    const std::size_t _allocated_bytes = _stats.allocated_bytes;
+    ASSERT_TRUE(embed_wow(_rgb, _width, _height, _steganography_key, 7, _payload, _options, _workspace, _rgb_embedded, _cost));
+    EXPECT_EQ(_allocated_bytes, _stats.allocated_bytes);
+    EXPECT_EQ(2 * _payload.size, _stats.payload_bit_count);
+    EXPECT_EQ(2 * _changed_pixels_count, _stats.changed_pixels_count);
+}
+}
@@ -0,0 +1,84 @@
+#include <array>
+#include <random>
+
+#include "gtest_env.hpp"
+#include <binghamton/core/lsb.hpp>
+#include <binghamton/core/ycbcr.hpp>
+
+namespace binghamton {
+
+TEST_F(binghamton, y_lsb_fused)
+{
+    // Mid-range pixels, so that every flip stays in range, and a few saturated ones
+    constexpr std::size_t _pixels_count = 64 * 1000 + 37;
+    std::mt19937 _generator(5);
+    std::uniform_int_distribution<int> _values(1, 254), _coin(0, 7);
+    std::vector<std::uint8_t> _rgb(3 * _pixels_count);
+    for (std::uint8_t& _value : _rgb) {
+        _value = static_cast<std::uint8_t>(_values(_generator));
+    }
+
+    // The fused plane is the one of the separate passes
+    std::vector<std::uint8_t> _y;
+    bit_vector _y_lsb, _y_lsb_fused;
+    encode_y(_rgb, _y);
+    encode_lsb(_y, _y_lsb);
+    encode_y_lsb(_rgb.data(), _pixels_count, _y_lsb_fused);
+    EXPECT_EQ(_y_lsb.size, _y_lsb_fused.size);
+    EXPECT_EQ(_y_lsb.words, _y_lsb_fused.words);
+
+    // Flipping flagged pixels gives the RGB of decode_lsb then decode_y, in place as well
+    bit_vector _flips, _y_lsb_embedded = _y_lsb;
+    _flips.resize(_pixels_count);
+    for (std::size_t _index = 0; _index < _pixels_count; ++_index) {
+        const bool _flip = _coin(_generator) == 0;
+        _flips.set(_index, _flip);
+        _y_lsb_embedded.set(_index, _y_lsb.get(_index) != _flip);
+    }
+    std::vector<std::uint8_t> _y_embedded, _rgb_embedded, _rgb_fused(_rgb.size());
+    decode_lsb(_y, _y_lsb_embedded, _y_embedded);
+    EXPECT_TRUE(decode_y(_rgb, _y_embedded, _rgb_embedded));
+    EXPECT_TRUE(decode_y_lsb(_rgb.data(), _flips, _rgb_fused.data()));
+    EXPECT_EQ(_rgb_embedded, _rgb_fused);
+    std::vector<std::uint8_t> _rgb_in_place = _rgb;
+    EXPECT_TRUE(decode_y_lsb(_rgb_in_place.data(), _flips, _rgb_in_place.data()));
+    EXPECT_EQ(_rgb_embedded, _rgb_in_place);
+
+    // A flip leaving the range moves the other way, here Y = 23 of (0, 1, 200) moving up instead of down
+    _rgb_in_place = _rgb;
+    _rgb_in_place[0] = 0;
+    _rgb_in_place[1] = 1;
+    _rgb_in_place[2] = 200;
+    _flips.set(0, true);
+    EXPECT_TRUE(decode_y_lsb(_rgb_in_place.data(), _flips, _rgb_in_place.data()));
+    EXPECT_EQ(1, _rgb_in_place[0]);
+    EXPECT_EQ(2, _rgb_in_place[1]);
+    EXPECT_EQ(201, _rgb_in_place[2]);
+
+    // A clipping pixel fails and leaves the original pixels, here Y = 178 of (0, 255, 255)
+    _rgb_in_place = _rgb;
+    _rgb_in_place[0] = 0;
+    _rgb_in_place[1] = 255;
+    _rgb_in_place[2] = 255;
+    const std::vector<std::uint8_t> _rgb_saturated = _rgb_in_place;
+    EXPECT_FALSE(decode_y_lsb(_rgb_in_place.data(), _flips, _rgb_in_place.data()));
+    EXPECT_EQ(_rgb_saturated, _rgb_in_place);
+
+    // Flips keep a pixel clipping or not, here (0, 1, 200) moving up and (255, 254, 1) moving down, so that
+    // the stego pixels give the unclipped pixels of the cover
+    std::vector<std::uint8_t> _rgb_edges = _rgb_saturated;
+    const std::array<std::uint8_t, 6> _edges = { 0, 1, 200, 255, 254, 1 };
+    std::copy(_edges.begin(), _edges.end(), _rgb_edges.begin() + 3);
+    bit_vector _edge_flips;
+    _edge_flips.resize(_pixels_count);
+    _edge_flips.set(1, true);
+    _edge_flips.set(2, true);
+    std::vector<std::uint8_t> _rgb_edges_embedded(_rgb_edges.size());
+    EXPECT_TRUE(decode_y_lsb(_rgb_edges.data(), _edge_flips, _rgb_edges_embedded.data()));
+    std::array<std::size_t, 4> _unclipped, _unclipped_embedded;
+    EXPECT_EQ(4u, find_unclipped_pixels(make_image_view(_rgb_edges, _pixels_count, 1), 4, _unclipped.data()));
+    EXPECT_EQ(4u, find_unclipped_pixels(make_image_view(_rgb_edges_embedded, _pixels_count, 1), 4, _unclipped_embedded.data()));
+    EXPECT_EQ(_unclipped, _unclipped_embedded);
+    EXPECT_EQ(1u, _unclipped[0]);
+}
+}